@@ -0,0 +1,501 @@
+// Anytime cover search for the Quine-McCluskey minimizer
+//
+// The reduced chart is packed into bit sets both ways: for each implicant
+// the terms it covers, and for each term the implicants that cover it.
+// Each implicant's cost under the chosen cost model is worked out once by
+// minimize() and passed in.  Covers are compared by total cost, then by
+// the model's tie break (see implicantCost()).
+//
+// The exact search branches on the uncovered term with the fewest
+// implicants left.  Once an implicant has been tried for that term, its
+// later siblings leave it out, so the same set is never built twice.  The
+// bound comes from terms that no single implicant covers two of: each of
+// them needs its own implicant, and that implicant costs at least as much
+// as the cheapest implicant that could cover it.
+
+#include "cover.h"
+
+#include <algorithm>
+#include <string.h>
+#include <time.h>
+
+using namespace std;
+
+typedef unsigned long long Word;
+#define WORD_BITS 64
+
+// how many search nodes go by between deadline checks
+#define CLOCK_INTERVAL 1024
+
+double nowSeconds(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+bool pastDeadline(double deadline){
+    return deadline > 0 && nowSeconds() > deadline;
+}
+
+static inline bool testBit(const Word* set, int i){
+    return (set[i / WORD_BITS] >> (i % WORD_BITS)) & 1;
+}
+
+static inline void setBit(Word* set, int i){
+    set[i / WORD_BITS] |= (Word)1 << (i % WORD_BITS);
+}
+
+// a cover is better if it costs less, or costs the same and wins the tie break
+static inline bool better(int cost, int tie, int bestCost, int bestTie){
+    return cost < bestCost || (cost == bestCost && tie < bestTie);
+}
+
+void implicantCost(const Term* t, const MinOptions& opts, int& cost, int& tie){
+    int lits = 0;
+    for (int k = 0; k < t->len; ++k){
+        if (t->bits[k] != '-')
+            lits++;
+    }
+
+    switch(opts.costModel){
+        case QM_COST_LITERALS:
+            cost = lits;
+            tie = 1;
+            break;
+
+        case QM_COST_WEIGHTED:
+            cost = opts.termWeight + opts.literalWeight * lits;
+            tie = lits;
+            break;
+
+        default:
+            cost = 1;
+            tie = lits;
+            break;
+    }
+}
+
+// an implicant to try at a search node: most new terms per unit of cost
+// first, then the smaller tie break
+struct Branch {
+    int gain;
+    int cost;
+    int tie;
+    int row;
+    bool operator< (const Branch& other) const {
+        int c = cost > 0 ? cost : 1;
+        int oc = other.cost > 0 ? other.cost : 1;
+        if (gain * oc != other.gain * c)
+            return gain * oc > other.gain * c;
+        return tie < other.tie;
+    }
+};
+
+struct CoverSearch {
+    int rows;
+    int cols;
+    int rowWords;
+    int colWords;
+    std::vector<Word> rowBits;  // rows x colWords: terms each implicant covers
+    std::vector<Word> colBits;  // cols x rowWords: implicants covering each term
+    std::vector<int> cost;      // per implicant, under the cost model
+    std::vector<int> tie;
+    std::vector<int> weight;    // what the greedy pass divides coverage by
+
+    std::vector<Term*> best;    // best cover found, without the essentials
+    int bestCost;
+    int bestTie;
+
+    const std::vector<Term*>* imps;
+    const std::vector<Term*>* essentials;
+    int essentialCost;
+    const MinOptions* opts;
+    double startTime;
+    double deadline;
+    long long nodes;
+    bool timedOut;
+    int lowerBound;
+
+    const Word* rowSet(int r) const { return &rowBits[(size_t)r * colWords]; }
+    const Word* colSet(int c) const { return &colBits[(size_t)c * rowWords]; }
+
+    void init(bool** table, const std::vector<Term*>& terms,
+            const std::vector<Term*>& imps, const std::vector<int>& cost,
+            const std::vector<int>& tie, const std::vector<Term*>& essentials,
+            int essentialCost, const MinOptions& opts, double startTime,
+            double deadline);
+    void report(int event);
+    void greedy();
+    int bound(const Word* covered, const Word* excluded, int& tieNeed, int& pick);
+    void search(const std::vector<Word>& covered, std::vector<Word>& excluded,
+            std::vector<int>& chosen, int chosenCost, int chosenTie);
+};
+
+void CoverSearch::report(int event){
+    if (opts->progress == NULL)
+        return;
+
+    std::vector<Term*> cover(*essentials);
+    cover.insert(cover.end(), best.begin(), best.end());
+
+    MinProgress p;
+    p.event = event;
+    p.cover = &cover;
+    p.coverTerms = cover.size();
+    p.coverLiterals = countLiterals(cover);
+    p.coverCost = bestCost + essentialCost;
+    p.lowerBound = lowerBound + essentialCost;
+    p.optimal = (event == QM_PROGRESS_DONE && !timedOut);
+    p.elapsed = nowSeconds() - startTime;
+    opts->progress(p, opts->progressCtx);
+}
+
+// Take the implicant that covers the most uncovered terms per unit of
+// weight (literals when counting terms, the model's cost otherwise) until
+// everything is covered, then drop any implicant the others make
+// redundant, most expensive first.
+void CoverSearch::greedy(){
+    std::vector<Word> covered(colWords, 0);
+    std::vector<bool> taken(rows, false);
+    std::vector<int> picked;
+    int left = cols;
+
+    while (left > 0){
+        int pick = -1;
+        int pickGain = 0;
+        for (int r = 0; r < rows; ++r){
+            if (taken[r])
+                continue;
+            const Word* set = rowSet(r);
+            int gain = 0;
+            for (int w = 0; w < colWords; ++w){
+                gain += __builtin_popcountll(set[w] & ~covered[w]);
+            }
+            if (gain == 0)
+                continue;
+            // gain / weight > pickGain / weight[pick], without dividing
+            int w = weight[r] > 0 ? weight[r] : 1;
+            int pickW = pick >= 0 && weight[pick] > 0 ? weight[pick] : 1;
+            if (pick < 0 || gain * pickW > pickGain * w){
+                pick = r;
+                pickGain = gain;
+            }
+        }
+        if (pick < 0)
+            break;  // can't happen for a chart built from prime implicants
+
+        taken[pick] = true;
+        picked.push_back(pick);
+        const Word* set = rowSet(pick);
+        for (int w = 0; w < colWords; ++w){
+            covered[w] |= set[w];
+        }
+        left -= pickGain;
+    }
+
+    // count how many chosen implicants cover each term
+    std::vector<int> hits(cols, 0);
+    for (int i = 0; i < picked.size(); ++i){
+        for (int c = 0; c < cols; ++c){
+            if (testBit(rowSet(picked[i]), c))
+                hits[c]++;
+        }
+    }
+    std::vector<int> order(picked);
+    for (int i = 0; i < order.size(); ++i){
+        for (int k = i+1; k < order.size(); ++k){
+            if (better(cost[order[i]], tie[order[i]], cost[order[k]], tie[order[k]]))
+                swap(order[i], order[k]);
+        }
+    }
+    for (int i = 0; i < order.size(); ++i){
+        int r = order[i];
+        bool needed = false;
+        for (int c = 0; c < cols && !needed; ++c){
+            if (testBit(rowSet(r), c) && hits[c] == 1)
+                needed = true;
+        }
+        if (needed)
+            continue;
+        for (int c = 0; c < cols; ++c){
+            if (testBit(rowSet(r), c))
+                hits[c]--;
+        }
+        picked.erase(std::find(picked.begin(), picked.end(), r));
+    }
+
+    best.clear();
+    bestCost = 0;
+    bestTie = 0;
+    for (int i = 0; i < picked.size(); ++i){
+        best.push_back((*imps)[picked[i]]);
+        bestCost += cost[picked[i]];
+        bestTie += tie[picked[i]];
+    }
+}
+
+// Lower bound on the cost (returned) and tie break (in tieNeed) still
+// needed to cover what is left, counting only implicants that are not
+// excluded.  Also picks the uncovered term with the fewest candidates to
+// branch on.  Returns -1 if some term can no longer be covered, and 0 with
+// pick = -1 if everything is covered.
+int CoverSearch::bound(const Word* covered, const Word* excluded, int& tieNeed, int& pick){
+    std::vector<Word> used(rowWords, 0);
+    int need = 0;
+    int fewest = 0;
+
+    tieNeed = 0;
+    pick = -1;
+    for (int c = 0; c < cols; ++c){
+        if (testBit(covered, c))
+            continue;
+
+        const Word* set = colSet(c);
+        int avail = 0;
+        bool disjoint = true;
+        for (int w = 0; w < rowWords; ++w){
+            Word rowsLeft = set[w] & ~excluded[w];
+            avail += __builtin_popcountll(rowsLeft);
+            if (rowsLeft & used[w])
+                disjoint = false;
+        }
+        if (avail == 0)
+            return -1;
+        if (pick < 0 || avail < fewest){
+            pick = c;
+            fewest = avail;
+        }
+
+        // no implicant shared with the terms counted so far, so this one
+        // needs an implicant of its own
+        if (disjoint){
+            int cheapest = -1;
+            int cheapestTie = -1;
+            for (int w = 0; w < rowWords; ++w){
+                Word rowsLeft = set[w] & ~excluded[w];
+                used[w] |= rowsLeft;
+                while (rowsLeft){
+                    int r = w * WORD_BITS + __builtin_ctzll(rowsLeft);
+                    rowsLeft &= rowsLeft - 1;
+                    if (cheapest < 0 || cost[r] < cheapest)
+                        cheapest = cost[r];
+                    if (cheapestTie < 0 || tie[r] < cheapestTie)
+                        cheapestTie = tie[r];
+                }
+            }
+            need += cheapest;
+            tieNeed += cheapestTie;
+        }
+    }
+    return need;
+}
+
+void CoverSearch::search(const std::vector<Word>& covered, std::vector<Word>& excluded,
+        std::vector<int>& chosen, int chosenCost, int chosenTie){
+    if (timedOut)
+        return;
+    nodes++;
+    // check the clock on the first node too, in case the time is already up
+    if (deadline > 0 && nodes % CLOCK_INTERVAL == 1 && nowSeconds() > deadline){
+        timedOut = true;
+        return;
+    }
+
+    int needTie = 0;
+    int pick = -1;
+    int need = bound(&covered[0], &excluded[0], needTie, pick);
+    if (need < 0)
+        return;
+
+    // everything covered
+    if (pick < 0){
+        if (better(chosenCost, chosenTie, bestCost, bestTie)){
+            best.clear();
+            for (int i = 0; i < chosen.size(); ++i){
+                best.push_back((*imps)[chosen[i]]);
+            }
+            bestCost = chosenCost;
+            bestTie = chosenTie;
+            report(QM_PROGRESS_IMPROVED);
+        }
+        return;
+    }
+
+    if (!better(chosenCost + need, chosenTie + needTie, bestCost, bestTie))
+        return;
+
+    // try the implicants that cover the picked term, best gain for the cost first
+    std::vector<Branch> branches;
+    const Word* set = colSet(pick);
+    for (int w = 0; w < rowWords; ++w){
+        Word rowsLeft = set[w] & ~excluded[w];
+        while (rowsLeft){
+            int r = w * WORD_BITS + __builtin_ctzll(rowsLeft);
+            rowsLeft &= rowsLeft - 1;
+            int gain = 0;
+            const Word* rs = rowSet(r);
+            for (int k = 0; k < colWords; ++k){
+                gain += __builtin_popcountll(rs[k] & ~covered[k]);
+            }
+            Branch b;
+            b.gain = gain;
+            b.cost = cost[r];
+            b.tie = tie[r];
+            b.row = r;
+            branches.push_back(b);
+        }
+    }
+    sort(branches.begin(), branches.end());
+
+    std::vector<Word> next(colWords);
+    std::vector<Word> saved(excluded);
+    for (int i = 0; i < branches.size() && !timedOut; ++i){
+        int r = branches[i].row;
+        const Word* rs = rowSet(r);
+        for (int k = 0; k < colWords; ++k){
+            next[k] = covered[k] | rs[k];
+        }
+        chosen.push_back(r);
+        search(next, excluded, chosen, chosenCost + cost[r], chosenTie + tie[r]);
+        chosen.pop_back();
+
+        // later siblings leave r out; that set has been searched
+        setBit(&excluded[0], r);
+    }
+    excluded = saved;
+}
+
+void CoverSearch::init(bool** table, const std::vector<Term*>& terms,
+        const std::vector<Term*>& imps, const std::vector<int>& cost,
+        const std::vector<int>& tie, const std::vector<Term*>& essentials,
+        int essentialCost, const MinOptions& opts, double startTime,
+        double deadline){
+    rows = imps.size();
+    cols = terms.size();
+    rowWords = (rows + WORD_BITS - 1) / WORD_BITS + 1;
+    colWords = (cols + WORD_BITS - 1) / WORD_BITS + 1;
+    rowBits.assign((size_t)rows * colWords, 0);
+    colBits.assign((size_t)cols * rowWords, 0);
+    for (int i = 0; i < rows; ++i){
+        for (int k = 0; k < cols; ++k){
+            if (table[i][k]){
+                setBit(&rowBits[(size_t)i * colWords], k);
+                setBit(&colBits[(size_t)k * rowWords], i);
+            }
+        }
+    }
+    this->cost = cost;
+    this->tie = tie;
+    weight.resize(rows);
+    for (int i = 0; i < rows; ++i){
+        // counting terms, every implicant costs the same; go by literals
+        weight[i] = opts.costModel == QM_COST_TERMS ? tie[i] : cost[i];
+    }
+
+    this->imps = &imps;
+    this->essentials = &essentials;
+    this->essentialCost = essentialCost;
+    this->opts = &opts;
+    this->startTime = startTime;
+    this->deadline = deadline;
+    nodes = 0;
+    timedOut = false;
+    lowerBound = 0;
+    bestCost = 0;
+    bestTie = 0;
+}
+
+void greedyCover(bool** table, const std::vector<Term*>& terms,
+        const std::vector<Term*>& imps, const std::vector<int>& cost,
+        const std::vector<int>& tie, const std::vector<Term*>& essentials,
+        int essentialCost, const MinOptions& opts, double startTime,
+        CoverBest& found){
+    CoverSearch s;
+    s.init(table, terms, imps, cost, tie, essentials, essentialCost, opts, startTime, 0);
+
+    // bounded below by the root of the search
+    std::vector<Word> covered(s.colWords, 0);
+    std::vector<Word> excluded(s.rowWords, 0);
+    int rootTie = 0;
+    int pick = -1;
+    s.lowerBound = s.bound(&covered[0], &excluded[0], rootTie, pick);
+    if (s.lowerBound < 0)
+        s.lowerBound = 0;
+    s.greedy();
+    s.report(QM_PROGRESS_GREEDY);
+
+    found.cover = s.best;
+    found.cost = s.bestCost;
+    found.tie = s.bestTie;
+    found.lowerBound = s.lowerBound;
+}
+
+void fallbackCover(const std::vector<Term*>& cover, int cost,
+        const MinOptions& opts, double startTime, MinStats& stats){
+    std::vector<Term*> none;
+    std::vector<int> nocost;
+    CoverSearch s;
+    s.init(NULL, none, none, nocost, nocost, none, 0, opts, startTime, 0);
+    s.best = cover;
+    s.bestCost = cost;
+    s.timedOut = true;
+    s.report(QM_PROGRESS_GREEDY);
+    s.report(QM_PROGRESS_DONE);
+
+    if (opts.log){
+        fprintf(opts.log, "Cover search: deadline reached before the chart, %d terms, cost %d\n",
+                (int)cover.size(), cost);
+    }
+    stats.searchNodes = 0;
+    stats.lowerBound = 0;
+    stats.optimal = false;
+}
+
+void exactCover(bool** table, const std::vector<Term*>& terms,
+        const std::vector<Term*>& imps, const std::vector<int>& cost,
+        const std::vector<int>& tie, const std::vector<Term*>& essentials,
+        int essentialCost, const MinOptions& opts, double startTime,
+        double deadline, CoverBest& found, MinStats& stats){
+    CoverSearch s;
+    s.init(table, terms, imps, cost, tie, essentials, essentialCost, opts, startTime, deadline);
+    s.best = found.cover;
+    s.bestCost = found.cost;
+    s.bestTie = found.tie;
+    s.lowerBound = found.lowerBound;
+
+    // improve on the greedy cover until it is proven optimal or time runs out
+    if (pastDeadline(deadline))
+        s.timedOut = true;
+    if (!s.timedOut){
+        std::vector<Word> covered(s.colWords, 0);
+        std::vector<Word> excluded(s.rowWords, 0);
+        int rootTie = 0;
+        int pick = -1;
+        int root = s.bound(&covered[0], &excluded[0], rootTie, pick);
+        // the reduced chart has the same minimum, so its bound may be tighter
+        if (root > s.lowerBound)
+            s.lowerBound = root;
+        if (s.bestCost > s.lowerBound || s.bestTie > rootTie){
+            std::vector<int> chosen;
+            s.search(covered, excluded, chosen, 0, 0);
+        }
+    }
+    if (!s.timedOut)
+        s.lowerBound = s.bestCost;
+    s.report(QM_PROGRESS_DONE);
+
+    if (opts.log){
+        fprintf(opts.log, "Cover search: %lld nodes, %d terms, cost %d%s\n",
+                s.nodes, (int)(s.best.size() + essentials.size()), s.bestCost + s.essentialCost,
+                s.timedOut ? ", deadline reached" : ", optimal");
+    }
+
+    stats.searchNodes = s.nodes;
+    stats.lowerBound = s.lowerBound + s.essentialCost;
+    stats.optimal = !s.timedOut;
+
+    found.cover = s.best;
+    found.cost = s.bestCost;
+    found.tie = s.bestTie;
+    found.lowerBound = s.lowerBound;
+}
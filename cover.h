@@ -0,0 +1,64 @@
+// Anytime cover search for the Quine-McCluskey minimizer
+//
+// Used by findMin() when MinOptions.anytime is set or the cost model is not
+// plain term count.  A greedy cover of the chart left after the essentials
+// come out is reported right away, before the dominance passes.  Then a
+// branch and bound search over the reduced chart reports every better
+// cover it finds until it proves one optimal or runs past the deadline.
+
+#ifndef COVER_H
+#define COVER_H
+
+#include <vector>
+
+#include "qm.h"
+
+// seconds on a monotonic clock, for deadlines
+double nowSeconds();
+
+// true once an absolute nowSeconds() deadline has gone by; 0 never does
+bool pastDeadline(double deadline);
+
+// cost of one implicant under opts.costModel, and its tie break
+void implicantCost(const Term* t, const MinOptions& opts, int& cost, int& tie);
+
+// the best cover found so far, not counting the essentials
+struct CoverBest {
+    std::vector<Term*> cover;
+    int cost;
+    int tie;
+    int lowerBound;     // no cover of the chart costs less
+
+    CoverBest() : cost(0), tie(0), lowerBound(0) {}
+};
+
+// Both searches pick rows of a chart (implicants x terms) that together
+// cover every term.  cost and tie hold each row's implicantCost().
+// 'essentials' are the implicants already taken out of the chart, costing
+// essentialCost in all; they are included in every reported cover but not
+// in found.cover.
+
+// Covers the chart greedily and reports it as the first answer.
+void greedyCover(bool** table, const std::vector<Term*>& terms,
+        const std::vector<Term*>& imps, const std::vector<int>& cost,
+        const std::vector<int>& tie, const std::vector<Term*>& essentials,
+        int essentialCost, const MinOptions& opts, double startTime,
+        CoverBest& found);
+
+// Reports a cover put together without a chart, when the deadline passes
+// before the chart is ready: first as the greedy answer, then as the
+// final one.  cost is its total under the cost model.
+void fallbackCover(const std::vector<Term*>& cover, int cost,
+        const MinOptions& opts, double startTime, MinStats& stats);
+
+// Branch and bound starting from the cover in found, on a chart that may
+// have been reduced further since.  Reports each better cover and then
+// the final one.  Deadline is an absolute nowSeconds() time, 0 for none;
+// if it has already passed, the search is skipped.
+void exactCover(bool** table, const std::vector<Term*>& terms,
+        const std::vector<Term*>& imps, const std::vector<int>& cost,
+        const std::vector<int>& tie, const std::vector<Term*>& essentials,
+        int essentialCost, const MinOptions& opts, double startTime,
+        double deadline, CoverBest& found, MinStats& stats);
+
+#endif
@@ -0,0 +1,311 @@
+// Multi-level factoring of a minimized cover
+//
+// Algebraic factoring in the style of GFACTOR: pull out the common cube,
+// find a level-0 kernel by repeatedly dividing by the most frequent
+// literal, divide the function by it (weak division), and factor the
+// quotient, divisor and remainder recursively.  When the quotient is a
+// single cube, fall back to splitting on the most frequent literal.
+//
+// Cubes are packed into one word with two bits per variable, bit 2k for
+// the variable itself and bit 2k+1 for its complement, so containment,
+// division and common cube are all mask operations.
+
+#include "qm.h"
+
+#include <algorithm>
+#include <string>
+
+using namespace std;
+
+typedef unsigned long long Cube;
+#define FACTOR_MAX_VARS 32
+
+// a node of the factored form: a literal, a product, or a sum
+struct Expr {
+    enum { ZERO, ONE, LIT, AND, OR };
+    int kind;
+    int lit;                // bit index of the literal, for LIT
+    std::vector<Expr> kids; // for AND and OR
+
+    Expr(int k = ZERO) : kind(k), lit(0) {}
+};
+
+static Expr literal(int lit){
+    Expr e(Expr::LIT);
+    e.lit = lit;
+    return e;
+}
+
+// product of a and b, flattening nested products
+static Expr andOf(const Expr& a, const Expr& b){
+    if (a.kind == Expr::ZERO || b.kind == Expr::ZERO)
+        return Expr(Expr::ZERO);
+    if (a.kind == Expr::ONE)
+        return b;
+    if (b.kind == Expr::ONE)
+        return a;
+
+    Expr e(Expr::AND);
+    if (a.kind == Expr::AND)
+        e.kids = a.kids;
+    else
+        e.kids.push_back(a);
+    if (b.kind == Expr::AND)
+        e.kids.insert(e.kids.end(), b.kids.begin(), b.kids.end());
+    else
+        e.kids.push_back(b);
+    return e;
+}
+
+// sum of a and b, flattening nested sums
+static Expr orOf(const Expr& a, const Expr& b){
+    if (a.kind == Expr::ONE || b.kind == Expr::ONE)
+        return Expr(Expr::ONE);
+    if (a.kind == Expr::ZERO)
+        return b;
+    if (b.kind == Expr::ZERO)
+        return a;
+
+    Expr e(Expr::OR);
+    if (a.kind == Expr::OR)
+        e.kids = a.kids;
+    else
+        e.kids.push_back(a);
+    if (b.kind == Expr::OR)
+        e.kids.insert(e.kids.end(), b.kids.begin(), b.kids.end());
+    else
+        e.kids.push_back(b);
+    return e;
+}
+
+static Expr cubeExpr(Cube c){
+    Expr e(Expr::ONE);
+    for (int b = 0; c != 0; ++b, c >>= 1){
+        if (c & 1)
+            e = andOf(e, literal(b));
+    }
+    return e;
+}
+
+static Expr sumOfCubes(const std::vector<Cube>& f){
+    Expr e(Expr::ZERO);
+    for (int i = 0; i < f.size(); ++i){
+        e = orOf(e, cubeExpr(f[i]));
+    }
+    return e;
+}
+
+// literals shared by every cube
+static Cube commonCube(const std::vector<Cube>& f){
+    Cube c = ~(Cube)0;
+    for (int i = 0; i < f.size(); ++i){
+        c &= f[i];
+    }
+    return f.empty() ? 0 : c;
+}
+
+// the literal that appears in the most cubes, and how many; -1 if none
+static int bestLiteral(const std::vector<Cube>& f, int& count){
+    int counts[2 * FACTOR_MAX_VARS] = {0};
+    for (int i = 0; i < f.size(); ++i){
+        for (Cube c = f[i]; c != 0; c &= c - 1){
+            counts[__builtin_ctzll(c)]++;
+        }
+    }
+    int best = -1;
+    count = 0;
+    for (int b = 0; b < 2 * FACTOR_MAX_VARS; ++b){
+        if (counts[b] > count){
+            best = b;
+            count = counts[b];
+        }
+    }
+    return best;
+}
+
+static void normalize(std::vector<Cube>& f){
+    sort(f.begin(), f.end());
+    f.erase(unique(f.begin(), f.end()), f.end());
+}
+
+// cubes of f containing cube d, with d taken out
+static std::vector<Cube> divideByCube(const std::vector<Cube>& f, Cube d){
+    std::vector<Cube> q;
+    for (int i = 0; i < f.size(); ++i){
+        if ((f[i] & d) == d)
+            q.push_back(f[i] & ~d);
+    }
+    normalize(q);
+    return q;
+}
+
+static std::vector<Cube> makeCubeFree(const std::vector<Cube>& f){
+    return divideByCube(f, commonCube(f));
+}
+
+// Weak division f = q*d + r.  q is the intersection over the cubes of d of
+// f divided by that cube; r is whatever q*d doesn't account for.
+static void divide(const std::vector<Cube>& f, const std::vector<Cube>& d,
+        std::vector<Cube>& q, std::vector<Cube>& r){
+    q.clear();
+    for (int i = 0; i < d.size(); ++i){
+        std::vector<Cube> qi = divideByCube(f, d[i]);
+        if (i == 0){
+            q = qi;
+        } else {
+            std::vector<Cube> both;
+            set_intersection(q.begin(), q.end(), qi.begin(), qi.end(), back_inserter(both));
+            q.swap(both);
+        }
+        if (q.empty())
+            break;
+    }
+
+    std::vector<Cube> qd;
+    for (int i = 0; i < q.size(); ++i){
+        for (int k = 0; k < d.size(); ++k){
+            qd.push_back(q[i] | d[k]);
+        }
+    }
+    normalize(qd);
+    r.clear();
+    set_difference(f.begin(), f.end(), qd.begin(), qd.end(), back_inserter(r));
+}
+
+// a level-0 kernel of cube-free f, or nothing if no literal is shared
+static std::vector<Cube> quickDivisor(const std::vector<Cube>& f){
+    std::vector<Cube> k = f;
+    bool divided = false;
+    while (true){
+        int count;
+        int lit = bestLiteral(k, count);
+        if (lit < 0 || count < 2)
+            break;
+        k = makeCubeFree(divideByCube(k, (Cube)1 << lit));
+        divided = true;
+    }
+    if (!divided)
+        k.clear();
+    return k;
+}
+
+static Expr factor(const std::vector<Cube>& f);
+
+// split on the most frequent literal: f = l*(f/l) + rest
+static Expr literalFactor(const std::vector<Cube>& f){
+    int count;
+    int lit = bestLiteral(f, count);
+    Cube l = (Cube)1 << lit;
+
+    std::vector<Cube> q = divideByCube(f, l);
+    std::vector<Cube> r;
+    for (int i = 0; i < f.size(); ++i){
+        if ((f[i] & l) == 0)
+            r.push_back(f[i]);
+    }
+    return orOf(andOf(literal(lit), factor(q)), factor(r));
+}
+
+static Expr factor(const std::vector<Cube>& f){
+    if (f.empty())
+        return Expr(Expr::ZERO);
+    for (int i = 0; i < f.size(); ++i){
+        if (f[i] == 0)
+            return Expr(Expr::ONE);
+    }
+    if (f.size() == 1)
+        return cubeExpr(f[0]);
+
+    Cube c = commonCube(f);
+    if (c != 0)
+        return andOf(cubeExpr(c), factor(divideByCube(f, c)));
+
+    std::vector<Cube> d = quickDivisor(f);
+    if (d.size() < 2)
+        return sumOfCubes(f);
+
+    std::vector<Cube> q, r;
+    divide(f, d, q, r);
+    if (q.size() == 1)
+        return literalFactor(f);
+
+    // divide again by the cube-free quotient, which may give a larger divisor
+    q = makeCubeFree(q);
+    std::vector<Cube> d2, r2;
+    divide(f, q, d2, r2);
+    if (d2.size() < 2 || commonCube(d2) != 0)
+        return literalFactor(f);
+
+    return orOf(andOf(factor(q), factor(d2)), factor(r2));
+}
+
+static int countLeaves(const Expr& e){
+    if (e.kind == Expr::LIT)
+        return 1;
+    int n = 0;
+    for (int i = 0; i < e.kids.size(); ++i){
+        n += countLeaves(e.kids[i]);
+    }
+    return n;
+}
+
+static void printExpr(const Expr& e, std::string& out){
+    switch(e.kind){
+        case Expr::ZERO:
+            out += "0";
+            break;
+
+        case Expr::ONE:
+            out += "1";
+            break;
+
+        case Expr::LIT:
+            out += (char)('A' + e.lit / 2);
+            if (e.lit & 1)
+                out += "'";
+            break;
+
+        case Expr::AND:
+            for (int i = 0; i < e.kids.size(); ++i){
+                if (e.kids[i].kind == Expr::OR){
+                    out += "(";
+                    printExpr(e.kids[i], out);
+                    out += ")";
+                } else {
+                    printExpr(e.kids[i], out);
+                }
+            }
+            break;
+
+        case Expr::OR:
+            for (int i = 0; i < e.kids.size(); ++i){
+                if (i > 0)
+                    out += " + ";
+                printExpr(e.kids[i], out);
+            }
+            break;
+    }
+}
+
+int factorCover(const std::vector<Term*>& cover, std::string& expr, int& literals){
+    std::vector<Cube> f;
+    for (int i = 0; i < cover.size(); ++i){
+        if (cover[i]->len > FACTOR_MAX_VARS)
+            return QM_ERR_INPUT;
+        Cube c = 0;
+        for (int k = 0; k < cover[i]->len; ++k){
+            if (cover[i]->bits[k] == '1')
+                c |= (Cube)1 << (2 * k);
+            else if (cover[i]->bits[k] == '0')
+                c |= (Cube)1 << (2 * k + 1);
+        }
+        f.push_back(c);
+    }
+    normalize(f);
+
+    Expr e = factor(f);
+    expr.clear();
+    printExpr(e, expr);
+    literals = countLeaves(e);
+    return QM_OK;
+}
@@ -0,0 +1,503 @@
+// Randomized differential test for the minimizer
+//
+// Generates seeded random functions the way gentest.pl does (each minterm
+// present half the time, one in ten of those a don't care), runs them
+// through every engine, and checks each cover by evaluating it over all
+// 2^n inputs with bit-parallel truth tables.  For small functions the
+// minimum cost of each engine is also checked against the other engines
+// and against an exact reference computed by brute force.
+//
+// Usage: qmfuzz [-n cases] [-s seed] [-v maxvars]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+#include "qm.h"
+#include "cover.h"
+
+using namespace std;
+
+typedef unsigned long long Word;
+
+// most variables the group search is given; it is exponential
+#define GROUP_SEARCH_MAX_VARS 5
+// and the most rows of the reduced chart, as branch and bound leaves it
+#define GROUP_SEARCH_MAX_ROWS 12
+// most variables the brute force reference is run for
+#define REFERENCE_MAX_VARS 4
+
+// xorshift64*, so each case only depends on its own seed
+struct Rng {
+    Word s;
+    Rng(Word seed) : s(seed * 2685821657736338717ULL + 1) {}
+    Word next(){
+        s ^= s >> 12;
+        s ^= s << 25;
+        s ^= s >> 27;
+        return s * 2685821657736338717ULL;
+    }
+    int below(int n){ return (int)(next() % n); }
+};
+
+// a truth table over n variables, one bit per minterm, variable A being
+// the most significant bit of the minterm number
+struct Table {
+    int n;
+    std::vector<Word> w;
+
+    Table(int vars = 0) : n(vars), w(vars > 6 ? (1 << (vars - 6)) : 1, 0) {}
+
+    // only the first 2^n bits mean anything
+    Word validMask() const {
+        return n >= 6 ? ~(Word)0 : (((Word)1 << (1 << n)) - 1);
+    }
+    void set(int m){ w[m / 64] |= (Word)1 << (m % 64); }
+    bool get(int m) const { return (w[m / 64] >> (m % 64)) & 1; }
+
+    void fill(bool v){
+        for (int i = 0; i < w.size(); ++i){
+            w[i] = v ? ~(Word)0 : 0;
+        }
+        w.back() &= validMask();
+    }
+    void operator|= (const Table& o){
+        for (int i = 0; i < w.size(); ++i) w[i] |= o.w[i];
+    }
+    void operator&= (const Table& o){
+        for (int i = 0; i < w.size(); ++i) w[i] &= o.w[i];
+    }
+    void invert(){
+        for (int i = 0; i < w.size(); ++i) w[i] = ~w[i];
+        w.back() &= validMask();
+    }
+    // true if every minterm here is also in o
+    bool within(const Table& o) const {
+        for (int i = 0; i < w.size(); ++i){
+            if (w[i] & ~o.w[i])
+                return false;
+        }
+        return true;
+    }
+    bool operator== (const Table& o) const { return w == o.w; }
+};
+
+// minterms where variable k is 1
+static Table variable(int n, int k){
+    static const Word low[6] = {
+        0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+        0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL
+    };
+    Table t(n);
+    int p = n - 1 - k;
+    for (int i = 0; i < t.w.size(); ++i){
+        if (p < 6)
+            t.w[i] = low[p];
+        else
+            t.w[i] = ((i >> (p - 6)) & 1) ? ~(Word)0 : 0;
+    }
+    t.w.back() &= t.validMask();
+    return t;
+}
+
+static Table cubeTable(const char* bits, int n){
+    Table t(n);
+    t.fill(true);
+    for (int k = 0; k < n; ++k){
+        if (bits[k] == '-')
+            continue;
+        Table v = variable(n, k);
+        if (bits[k] == '0')
+            v.invert();
+        t &= v;
+    }
+    return t;
+}
+
+static Table coverTable(const std::vector<Term*>& cover, int n){
+    Table t(n);
+    for (int i = 0; i < cover.size(); ++i){
+        t |= cubeTable(cover[i]->bits, n);
+    }
+    return t;
+}
+
+// Evaluates a factored expression as printed by factorCover():
+//   expr := product ('+' product)*
+//   product := factor+
+//   factor := letter [']  |  '(' expr ')'  |  '0'  |  '1'
+struct ExprEval {
+    const char* p;
+    int n;
+    bool bad;
+
+    void skip(){ while (*p == ' ') p++; }
+
+    Table expr(){
+        Table t = product();
+        skip();
+        while (*p == '+'){
+            p++;
+            t |= product();
+            skip();
+        }
+        return t;
+    }
+    Table product(){
+        Table t(n);
+        t.fill(true);
+        int factors = 0;
+        skip();
+        while (*p && *p != '+' && *p != ')'){
+            t &= factor();
+            factors++;
+            skip();
+        }
+        if (factors == 0)
+            bad = true;
+        return t;
+    }
+    Table factor(){
+        Table t(n);
+        if (*p == '('){
+            p++;
+            t = expr();
+            if (*p != ')')
+                bad = true;
+            else
+                p++;
+        } else if (*p == '0' || *p == '1'){
+            t.fill(*p == '1');
+            p++;
+        } else if (*p >= 'A' && *p < 'A' + n){
+            t = variable(n, *p - 'A');
+            p++;
+            if (*p == '\''){
+                t.invert();
+                p++;
+            }
+        } else {
+            bad = true;
+            p++;
+        }
+        return t;
+    }
+};
+
+struct Cost {
+    int cost;
+    int tie;
+    bool operator== (const Cost& o) const { return cost == o.cost && tie == o.tie; }
+};
+
+// Exact minimum cover cost by brute force: every implicant of the function,
+// the primes among them, and a memoized search over the sets of ON
+// minterms still to cover.
+static Cost referenceCost(const Table& on, const Table& dc, int n, const MinOptions& opts){
+    Table allowed = on;
+    allowed |= dc;
+
+    std::vector<std::string> primes;
+    int cubes = 1;
+    for (int k = 0; k < n; ++k){
+        cubes *= 3;
+    }
+    for (int x = 0; x < cubes; ++x){
+        std::string c(n, '-');
+        for (int k = 0, y = x; k < n; ++k, y /= 3){
+            c[k] = "01-"[y % 3];
+        }
+        if (!cubeTable(c.c_str(), n).within(allowed))
+            continue;
+        bool prime = true;
+        for (int k = 0; k < n && prime; ++k){
+            if (c[k] == '-')
+                continue;
+            std::string d = c;
+            d[k] = '-';
+            if (cubeTable(d.c_str(), n).within(allowed))
+                prime = false;
+        }
+        if (prime)
+            primes.push_back(c);
+    }
+
+    // ON minterms get numbered 0..m-1 so a set of them fits in an int
+    std::vector<int> onIndex(1 << n, -1);
+    int m = 0;
+    for (int t = 0; t < (1 << n); ++t){
+        if (on.get(t))
+            onIndex[t] = m++;
+    }
+    std::vector<int> covers(primes.size(), 0);
+    std::vector<Cost> cost(primes.size());
+    for (int i = 0; i < primes.size(); ++i){
+        Table ct = cubeTable(primes[i].c_str(), n);
+        for (int t = 0; t < (1 << n); ++t){
+            if (onIndex[t] >= 0 && ct.get(t))
+                covers[i] |= 1 << onIndex[t];
+        }
+        Term term(n);
+        memcpy(term.bits, primes[i].c_str(), n);
+        implicantCost(&term, opts, cost[i].cost, cost[i].tie);
+    }
+
+    // best[s] = cheapest way to cover the minterms not in s
+    int full = (1 << m) - 1;
+    std::vector<Cost> best(1 << m);
+    best[full].cost = 0;
+    best[full].tie = 0;
+    for (int s = full - 1; s >= 0; --s){
+        int low = __builtin_ctz(~s);
+        Cost b = { 1 << 30, 1 << 30 };
+        for (int i = 0; i < primes.size(); ++i){
+            if (!(covers[i] & (1 << low)))
+                continue;
+            const Cost& rest = best[s | covers[i]];
+            Cost c = { rest.cost + cost[i].cost, rest.tie + cost[i].tie };
+            if (c.cost < b.cost || (c.cost == b.cost && c.tie < b.tie))
+                b = c;
+        }
+        best[s] = b;
+    }
+    return best[0];
+}
+
+// the engines every case is run through, branch and bound first so its
+// chart size can decide whether the group search is worth running.  The
+// last two run out of time somewhere between merging and the search, so
+// only the fallback cover's validity is checked.
+enum { TERMS, GROUP, LITERALS, WEIGHTED, SPILL, DEADLINE, SPILL_DEADLINE, NUM_ENGINES };
+static const char* engineNames[NUM_ENGINES] = {
+    "branch and bound", "group search", "literal cost", "weighted cost", "spill + branch and bound",
+    "out of time", "spill, out of time"
+};
+
+static MinOptions engineOptions(int engine){
+    MinOptions opts;
+    opts.deadline = 5;
+    switch(engine){
+        case TERMS:
+            opts.anytime = true;
+            break;
+
+        case LITERALS:
+            opts.costModel = QM_COST_LITERALS;
+            break;
+
+        case WEIGHTED:
+            opts.costModel = QM_COST_WEIGHTED;
+            opts.termWeight = 3;
+            opts.literalWeight = 1;
+            break;
+
+        case SPILL:
+            opts.anytime = true;
+            opts.memBudget = 256;   // a handful of records per run
+            break;
+
+        case DEADLINE:
+            opts.anytime = true;
+            break;
+
+        case SPILL_DEADLINE:
+            opts.anytime = true;
+            opts.memBudget = 256;
+            break;
+    }
+    return opts;
+}
+
+static int failures = 0;
+
+static void fail(Word seed, int n, const char* table, const char* what){
+    failures++;
+    printf("FAIL seed %llu, %d vars: %s\n  table: %.*s\n", seed, n, what, 1 << n, table);
+}
+
+static void runCase(Word seed, int maxVars){
+    Rng rng(seed);
+    int n = 1 + rng.below(maxVars);
+
+    std::vector<char> table(1 << n);
+    Table on(n), dc(n);
+    for (int t = 0; t < (1 << n); ++t){
+        table[t] = '0';
+        if (rng.below(2) == 1){
+            if (rng.below(10) == 0){
+                table[t] = 'd';
+                dc.set(t);
+            } else {
+                table[t] = '1';
+                on.set(t);
+            }
+        }
+    }
+    Table allowed = on;
+    allowed |= dc;
+
+    Cost costs[NUM_ENGINES];
+    bool optimal[NUM_ENGINES];
+    int chartRows = 0;
+    char msg[200];
+    for (int e = 0; e < NUM_ENGINES; ++e){
+        optimal[e] = false;
+        if (e == GROUP && (n > GROUP_SEARCH_MAX_VARS || chartRows > GROUP_SEARCH_MAX_ROWS))
+            continue;
+
+        MinOptions opts = engineOptions(e);
+        if (e == DEADLINE || e == SPILL_DEADLINE)
+            opts.deadline = 1e-6 * (1 + rng.below(500));
+        MinResult result;
+        int err = minimizeTruthTable(n, &table[0], result, opts);
+        if (err != QM_OK){
+            snprintf(msg, sizeof(msg), "%s returned error %d", engineNames[e], err);
+            fail(seed, n, &table[0], msg);
+            continue;
+        }
+
+        Table f = coverTable(result.cover, n);
+        if (!on.within(f)){
+            snprintf(msg, sizeof(msg), "%s cover misses ON minterms", engineNames[e]);
+            fail(seed, n, &table[0], msg);
+        }
+        if (!f.within(allowed)){
+            snprintf(msg, sizeof(msg), "%s cover includes OFF minterms", engineNames[e]);
+            fail(seed, n, &table[0], msg);
+        }
+
+        int cost, tie;
+        costs[e].cost = 0;
+        costs[e].tie = 0;
+        for (int i = 0; i < result.cover.size(); ++i){
+            implicantCost(result.cover[i], opts, cost, tie);
+            costs[e].cost += cost;
+            costs[e].tie += tie;
+        }
+        optimal[e] = (e == GROUP) || result.stats.optimal;
+        if (e == TERMS)
+            chartRows = result.stats.chartRows;
+
+        // the cover handed back as cubes, with the same don't cares, has
+        // to minimize to a cover of the same function
+        if (e == TERMS){
+            std::vector<Term*> cubes;
+            for (int i = 0; i < result.cover.size(); ++i){
+                cubes.push_back(new Term(*result.cover[i]));
+            }
+            for (int t = 0; t < (1 << n); ++t){
+                if (!dc.get(t))
+                    continue;
+                Term* term = new Term(n);
+                for (int k = 0; k < n; ++k){
+                    if (t & (1 << (n-k-1)))
+                        term->bits[k] = '1';
+                }
+                term->dontcare = true;
+                cubes.push_back(term);
+            }
+            MinResult again;
+            err = minimize(cubes, again, opts);
+            Table g = coverTable(again.cover, n);
+            if (err != QM_OK){
+                snprintf(msg, sizeof(msg), "cube input returned error %d", err);
+                fail(seed, n, &table[0], msg);
+            } else if (!f.within(g) || !g.within(allowed)){
+                fail(seed, n, &table[0], "cube input gave a different function");
+            }
+            freeTerms(cubes);
+        }
+
+        // the factored form has to be the same function, and no bigger
+        if (e == TERMS){
+            std::string expr;
+            int literals = 0;
+            if (factorCover(result.cover, expr, literals) != QM_OK){
+                fail(seed, n, &table[0], "factorCover failed");
+            } else {
+                ExprEval ev;
+                ev.p = expr.c_str();
+                ev.n = n;
+                ev.bad = false;
+                Table g = ev.expr();
+                if (ev.bad || *ev.p != 0){
+                    snprintf(msg, sizeof(msg), "unparsable factored form \"%s\"", expr.c_str());
+                    fail(seed, n, &table[0], msg);
+                } else if (!(g == f)){
+                    snprintf(msg, sizeof(msg), "factored form \"%s\" differs from the cover", expr.c_str());
+                    fail(seed, n, &table[0], msg);
+                } else if (literals > result.stats.coverLiterals){
+                    fail(seed, n, &table[0], "factored form has more literals than the cover");
+                }
+            }
+        }
+    }
+
+    // engines minimizing the same thing have to agree on the minimum
+    if (optimal[TERMS] && optimal[SPILL] && !(costs[TERMS] == costs[SPILL])){
+        snprintf(msg, sizeof(msg), "branch and bound cost %d/%d, with spilling %d/%d",
+                costs[TERMS].cost, costs[TERMS].tie, costs[SPILL].cost, costs[SPILL].tie);
+        fail(seed, n, &table[0], msg);
+    }
+    if (optimal[GROUP] && optimal[TERMS] && !(costs[GROUP] == costs[TERMS])){
+        snprintf(msg, sizeof(msg), "group search cost %d/%d, branch and bound %d/%d",
+                costs[GROUP].cost, costs[GROUP].tie, costs[TERMS].cost, costs[TERMS].tie);
+        fail(seed, n, &table[0], msg);
+    }
+    if (n <= REFERENCE_MAX_VARS){
+        int engines[3] = { TERMS, LITERALS, WEIGHTED };
+        for (int i = 0; i < 3; ++i){
+            int e = engines[i];
+            if (!optimal[e])
+                continue;
+            Cost ref = referenceCost(on, dc, n, engineOptions(e));
+            if (!(ref == costs[e])){
+                snprintf(msg, sizeof(msg), "%s cost %d/%d, exact minimum %d/%d", engineNames[e],
+                        costs[e].cost, costs[e].tie, ref.cost, ref.tie);
+                fail(seed, n, &table[0], msg);
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv){
+    int cases = 2000;
+    Word seed = 1;
+    int maxVars = 7;
+
+    int c;
+    while ((c = getopt(argc, argv, "n:s:v:")) != -1){
+        switch(c){
+            case 'n':
+                cases = atoi(optarg);
+                break;
+
+            case 's':
+                seed = strtoull(optarg, NULL, 10);
+                break;
+
+            case 'v':
+                maxVars = atoi(optarg);
+                break;
+
+            default:
+                printf("Usage: %s [-n cases] [-s seed] [-v maxvars]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (maxVars < 1 || maxVars > 16){
+        printf("maxvars must be between 1 and 16\n");
+        return 1;
+    }
+
+    for (int i = 0; i < cases; ++i){
+        runCase(seed + i, maxVars);
+    }
+
+    printf("%d cases, seeds %llu..%llu, up to %d variables: %d failures\n",
+            cases, seed, seed + cases - 1, maxVars, failures);
+    return failures == 0 ? 0 : 1;
+}
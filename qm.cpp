@@ -0,0 +1,982 @@
+// Quine-McCluskey minimization
+//
+// Patrick Mealey
+// Joseph Gebhard
+
+#include "qm.h"
+#include "spill.h"
+#include "cover.h"
+
+#include <vector>
+#include <algorithm>
+#include <string.h>
+
+using namespace std;
+
+//displays everything in the term vector one term per line
+//
+void printTerms(FILE* out, const std::vector<Term*>& terms){
+    // for each term
+    for (int i = 0; i < terms.size(); ++i){
+        fprintf(out, "Term: %s  %c%c\n", 
+                terms[i]->bits, 
+                terms[i]->dontcare ? 'd' : '1', 
+                terms[i]->essential ? '*' : ' ');
+    }
+}
+
+// TODO: this could be made more efficient... 
+// we shouldn't need to compare every term to every other term.
+// mergeTermsOnce returns a new vector of merged terms, 
+// and modifies the terms in the input vector to mark those that are essential
+// If the deadline passes, it gives up on the round, sets timedOut and
+// returns nothing.
+static std::vector<Term*> mergeTermsOnce(const std::vector<Term*>& terms, double deadline, bool& timedOut){
+    std::vector<Term*> newterms;
+
+    // mark all terms essential
+    for(int i = 0; i < terms.size(); ++i){
+        if (terms[i]->dontcare == false)
+            terms[i]->essential = true;
+    }
+    // for each term
+    for (int i = 0; i < terms.size(); ++i){
+        if (pastDeadline(deadline)){
+            timedOut = true;
+            freeTerms(newterms);
+            return newterms;
+        }
+        // for each term after i
+        for (int k = i+1; k < terms.size(); ++k){
+            int bitdiff = -1;
+            // for each bit
+            for (int m = 0; m < terms[i]->len && m < terms[k]->len; ++m){
+                // if bits differ
+                if (terms[i]->bits[m] != terms[k]->bits[m]){
+                    // if this is the second difference, break out
+                    if (bitdiff != -1){
+                        bitdiff = -1;
+                        break;
+                    // otherwise, mark it
+                    } else {
+                        bitdiff = m;
+                    }
+                }
+            }
+            // if there was a single bit difference, merge
+            if (bitdiff > -1){
+                terms[i]->essential = false;
+                terms[k]->essential = false;
+                Term* new1 = new Term(*terms[i]);
+                if (terms[i]->dontcare == false || terms[k]->dontcare == false)
+                    new1->dontcare=false;
+                new1->bits[bitdiff] = '-';
+                newterms.push_back(new1);
+            }
+        }
+    }
+    // check for duplicates
+    for (int i = 0; i < newterms.size(); ++i){
+        if (pastDeadline(deadline)){
+            timedOut = true;
+            freeTerms(newterms);
+            return newterms;
+        }
+        for (int k = i+1; k < newterms.size(); ++k){
+            // if 2 entries match, remove the latter one and continue
+            if (strncmp(newterms[i]->bits, newterms[k]->bits, newterms[i]->len) == 0){
+                delete newterms[k];
+                newterms.erase(newterms.begin() + k);
+                k--;
+            }
+        }
+    }
+    return newterms;
+}
+
+// Returns the prime implicants.  If the deadline (an absolute nowSeconds()
+// time, 0 for none) passes first, finished is set false and what comes back
+// is the cubes set aside so far plus the last full round: not all prime,
+// but together still covering every one.
+static std::vector<Term*> mergeTerms(const std::vector<Term*>& terms, MinStats& stats, double deadline, bool& finished){
+    std::vector<Term*> merged;
+    std::vector<Term*> lastmerged;
+
+    std::vector<Term*> essential;
+
+    // copy terms into merged
+    std::vector<Term*>::iterator it;
+    for (std::vector<Term*>::const_iterator cit = terms.begin(); cit != terms.end(); ++cit){
+        Term* copy = new Term(*(*cit));
+        merged.push_back(copy);
+    }
+
+    bool done = false;
+    // loop until nothing can be merged.
+    while(done == false){
+        // TODO: Fix memory leak -- delete the Terms in lastmerged first.
+        // if i understood what you meant then i fixed the memory leak
+        
+        for (it = lastmerged.begin(); it != lastmerged.end(); ++it){
+            delete (*it);	
+        }
+
+        lastmerged = merged;
+        bool timedOut = false;
+        merged = mergeTermsOnce(lastmerged, deadline, timedOut);
+        if (timedOut){
+            for (int i = 0; i < lastmerged.size(); ++i){
+                if (lastmerged[i]->dontcare == false)
+                    essential.push_back(new Term(*lastmerged[i]));
+            }
+            finished = false;
+            break;
+        }
+        stats.mergeRounds++;
+
+        // add anything that couldn't be merged to the essential vector
+        for(int i = 0; i < lastmerged.size(); ++i){
+            if (lastmerged[i]->essential){
+                Term* newterm = new Term(*lastmerged[i]);
+                essential.push_back(newterm);
+            }
+        }
+        if (merged.size() == 0)
+            done = true;
+    }
+
+    // clean up 
+    for (it = lastmerged.begin(); it != lastmerged.end(); ++it){
+        delete (*it);
+    }
+
+    return essential;
+}
+
+static void printPIchart(FILE* out, bool** table, const std::vector<Term*>& terms, const std::vector<Term*>& implicants){
+    if (out == NULL)
+        return;
+    if (implicants.size() == 0){
+        fprintf(out, "No prime implicants for table.\n");
+        return;
+    }
+    if (terms.size() == 0){
+        fprintf(out, "No terms for table.\n");
+        return;
+    }
+    char fmt[50];
+    snprintf(fmt, 50, "%%%ds", implicants[0]->len + 2);
+    fprintf(out, fmt, " ");
+    for (int i = 0; i < terms.size(); ++i){
+        fprintf(out, " %s ", terms[i]->bits);
+    }
+    fprintf(out, "\n");
+
+    for (int i = 0; i < implicants.size(); ++i){
+        int mod = (implicants[i]->len % 2 == 1 ? 0 : 1);
+        fprintf(out, "%s%c ", implicants[i]->bits, implicants[i]->essential ? '*' : ' ');
+        for(int k = 0; k < terms.size(); ++k){
+            snprintf(fmt, 50, " %%%ds%%s%%%ds ", (terms[k]->len)/2-mod, (terms[k]->len)/2);
+            fprintf(out, fmt, " ", table[i][k] ? "x" : " ", " "); 
+        }
+        fprintf(out, "\n");
+    }
+}
+// Build the Prime Implicant Chart
+// Returns NULL if the deadline (0 for none) passes before it is done.
+static bool** buildPI(const std::vector<Term*>& terms, const std::vector<Term*>& implicants, double deadline = 0){
+    // create table
+    bool** table = new bool*[implicants.size()];
+    for(int i = 0; i < implicants.size(); ++i){
+        table[i] = new bool[terms.size()];
+        memset(table[i], 0, terms.size());
+    }
+    
+    // fill it in
+    for (int i = 0; i < implicants.size(); ++i){
+        if (pastDeadline(deadline)){
+            for (int k = 0; k < implicants.size(); ++k){
+                delete[] table[k];
+            }
+            delete[] table;
+            return NULL;
+        }
+        for(int k = 0; k < terms.size(); ++k){
+            bool covers = true;
+            for (int m = 0; m < implicants[i]->len; ++m){
+                // if implicant bit == 0 and term bit isn't, 
+                // this implicant does not cover the term
+                if (implicants[i]->bits[m] == '0' && terms[k]->bits[m] != '0')
+                    covers = false;
+                // if implicant bit == 1 and term bit isn't, 
+                // this implicant does not cover the term
+                else if (implicants[i]->bits[m] == '1' && terms[k]->bits[m] != '1')
+                    covers = false;
+            }
+            if (covers){
+                table[i][k] = true;
+            }
+        }
+    }
+    return table;
+}
+
+// Drops dominated columns and rows from the chart, and terms left with no
+// implicant, rebuilding table_ to match.  impcost and imptie are kept in
+// step with imps_.  If the deadline (an absolute nowSeconds() time, 0 for
+// none) passes during a dominance pass, that pass and the rest are skipped
+// and false is returned; the chart is still consistent, just less reduced.
+static bool reduceChart(bool**& table_, std::vector<Term*>& terms_, std::vector<Term*>& imps_,
+        std::vector<int>& impcost, std::vector<int>& imptie, FILE* log, double deadline){
+    // "Row" dominance -- column dominance here
+    // If a term dominates another term, then the dominating one can be ignored
+    std::vector<Term*> toRemove;
+    for (int i = 0; i < terms_.size(); ++i){
+        if (pastDeadline(deadline))
+            return false;
+        for (int k = i+1; k < terms_.size(); ++k){
+            bool domk = true;
+            bool domi = true;
+            for (int m = 0; m < imps_.size(); ++m){
+                if (table_[m][i] == true && table_[m][k] == false){
+                    domi = false;
+                }
+                if (table_[m][k] == true && table_[m][i] == false){
+                    domk = false;
+                }
+            }
+            if (domk){
+                toRemove.push_back(terms_[i]);
+                if (log) fprintf(log, "Col %d dominates col %d\n", i, k);
+            } else if (domi){
+                toRemove.push_back(terms_[k]);
+                if (log) fprintf(log, "Col %d dominates col %d\n", k, i);
+            }
+        }
+    } 
+
+    // remove columns that dominate others
+    if (log) fprintf(log, "imps size: %d, terms size: %d\n", (int)imps_.size(), (int)terms_.size());
+    for (int i = 0; i < terms_.size(); ++i){
+        for (int k = 0; k < toRemove.size(); ++k){
+            if (*(toRemove[k]) == *(terms_[i])){
+                toRemove.erase(toRemove.begin() + k);
+                terms_.erase(terms_.begin() + i);
+                i--;
+                break;
+            }
+        }
+    }
+    if (log) fprintf(log, "imps size: %d, terms size: %d\n", (int)imps_.size(), (int)terms_.size());
+
+    // clean up old table_
+    for (int i = 0; i < imps_.size(); ++i){
+        delete[] table_[i];
+    }
+    delete[] table_;
+
+    table_ = buildPI(terms_, imps_);
+
+    printPIchart(log, table_, terms_, imps_);
+
+
+    // "Column" dominance -- actually rows in the table here...
+    // If a prime implicant covers another completely, then the covered one can be ignored
+    // -- unless the covered one is cheaper under the cost model, or costs the
+    // same and wins the tie break (fewer literals when counting terms).
+    toRemove.clear();
+    for (int i = 0; i < imps_.size(); ++i){
+        if (pastDeadline(deadline))
+            return false;
+        for (int k = i+1; k < imps_.size(); ++k){
+            bool dom1 = true;
+            bool dom2 = true;
+            for (int m = 0; m < terms_.size(); ++m){
+                if (table_[i][m] == true && table_[k][m] == false){
+                    dom1 = false;
+                }
+                if (table_[k][m] == true && table_[i][m] == false){
+                    dom2 = false;
+                }
+            }
+            bool icheaper = impcost[i] < impcost[k] || (impcost[i] == impcost[k] && imptie[i] <= imptie[k]);
+            bool kcheaper = impcost[k] < impcost[i] || (impcost[k] == impcost[i] && imptie[k] <= imptie[i]);
+            if (dom2 && icheaper){
+                toRemove.push_back(imps_[k]);
+                if (log) fprintf(log, "Row %d dominates row %d\n", i, k);
+            } else if (dom1 && kcheaper){
+                toRemove.push_back(imps_[i]);
+                if (log) fprintf(log, "Row %d dominates row %d\n", k, i);
+            }
+        }
+    }
+
+    // remove rows that are dominated
+    if (log) fprintf(log, "imps size: %d, terms size: %d\n", (int)imps_.size(), (int)terms_.size());
+    bool* impignore = new bool[imps_.size()];
+    for (int i = 0; i < imps_.size(); ++i){
+        impignore[i] = false;
+    }
+    int impidx = 0;
+    int impsize = imps_.size();
+    for (int i = 0; i < imps_.size(); ++i){
+        for (int k = 0; k < toRemove.size(); ++k){
+            if (*(toRemove[k]) == *(imps_[i])){
+                toRemove.erase(toRemove.begin() + k);
+                imps_.erase(imps_.begin() + i);
+                impcost.erase(impcost.begin() + i);
+                imptie.erase(imptie.begin() + i);
+                impignore[impidx] = true;
+                i--;
+                break;
+            }
+        }
+        impidx++;
+    }
+
+    // now remove terms that are unused
+    toRemove.clear();
+    for (int k = 0; k < terms_.size(); ++k){
+        bool hastrue = false;
+        for (int i = 0; i < impsize; ++i){
+            if (impignore[i] == false)
+                hastrue = hastrue || table_[i][k];
+        }
+        if (hastrue == false){
+            toRemove.push_back(terms_[k]);
+        }
+    }
+    for (int i = 0; i < terms_.size(); ++i){
+        for (int k = 0; k < toRemove.size(); ++k){
+            if (*(toRemove[k]) == *(terms_[i])){
+                toRemove.erase(toRemove.begin() + k);
+                terms_.erase(terms_.begin() + i);
+                i--;
+                break;
+            }
+        }
+    }
+    // clean up the impignore table
+    delete[] impignore;
+    impignore = NULL;
+
+    if (log) fprintf(log, "imps size: %d, terms size: %d\n", (int)imps_.size(), (int)terms_.size());
+
+    // clean up old table_
+    for (int i = 0; i < impsize; ++i){
+        delete[] table_[i];
+    }
+    delete[] table_;
+
+    table_ = buildPI(terms_, imps_);
+    impsize = imps_.size();
+
+    printPIchart(log, table_, terms_, imps_);
+    return true;
+}
+
+// The cover reported when the deadline passes before the chart is ready:
+// every implicant merging got to, which between them cover every one, or
+// the ones by themselves if that is cheaper.  In that case implicants,
+// cost and tie are replaced by copies of the ones and their costs.  Sorted
+// by address like findMin()'s covers.
+static std::vector<Term*> fallbackMin(std::vector<Term*>& implicants, std::vector<int>& cost, std::vector<int>& tie,
+        const std::vector<Term*>& ones, const MinOptions& opts, double startTime, MinStats& stats){
+    std::vector<int> onecost(ones.size());
+    std::vector<int> onetie(ones.size());
+    int total = 0;
+    int onesTotal = 0;
+    for (int i = 0; i < implicants.size(); ++i){
+        total += cost[i];
+    }
+    for (int i = 0; i < ones.size(); ++i){
+        implicantCost(ones[i], opts, onecost[i], onetie[i]);
+        onesTotal += onecost[i];
+    }
+    if (onesTotal < total){
+        freeTerms(implicants);
+        for (int i = 0; i < ones.size(); ++i){
+            implicants.push_back(new Term(*ones[i]));
+        }
+        cost = onecost;
+        tie = onetie;
+        total = onesTotal;
+    }
+
+    std::vector<Term*> ret(implicants);
+    sort(ret.begin(), ret.end());
+    fallbackCover(ret, total, opts, startTime, stats);
+    return ret;
+}
+
+// cost and tie give each implicant's cost under the cost model, worked
+// out once by the caller.  If the anytime deadline passes before the
+// reduced chart is built, outOfTime is set and nothing is returned.
+static std::vector<Term*> findMin(bool** table, const std::vector<Term*>& terms, const std::vector<Term*>& implicants,
+        const std::vector<int>& cost, const std::vector<int>& tie, const MinOptions& opts, double startTime, MinStats& stats,
+        bool& outOfTime){
+    FILE* log = opts.log;
+    bool anytime = opts.anytime || opts.costModel != QM_COST_TERMS;
+    double deadline = anytime && opts.deadline > 0 ? startTime + opts.deadline : 0;
+    bool** table_ = table;
+    std::vector<Term*> imps_ = implicants;
+    std::vector<Term*> terms_ = terms;
+
+    // TODO: not sure whether this loop is useful or not...
+    //          Apparently it breaks things...
+    bool shrunk = true;
+    //while(shrunk){
+    //    shrunk = false;
+        // if a column has only one 'x', then that implicant is essential.
+        for (int k = 0; k < terms_.size(); ++k){
+            int x = -1;
+            for (int i = 0; i < imps_.size(); ++i){
+                if (table[i][k] && x >= 0){
+                    x = -1;
+                    break;
+                } else if (table[i][k]){
+                    x = i;
+                }
+            }
+            if (x >= 0){
+                // implicant x is essential
+                imps_[x]->essential = true;
+                shrunk = true;
+            }
+        }
+
+        // check if we have any non-essential implicants
+        bool foundnes = false;
+        for (int i = 0; i < implicants.size(); ++i){
+            if (implicants[i]->essential == false){
+                foundnes = true;
+            }
+        }
+        if (foundnes == false){
+            std::vector<Term*> ret;
+            for (int i = 0; i < implicants.size(); ++i){
+                if (implicants[i]->essential)
+                    ret.push_back(implicants[i]);
+            }
+            sort(ret.begin(), ret.end());
+            stats.numEssential = ret.size();
+            if (opts.anytime || opts.costModel != QM_COST_TERMS){
+                // nothing left to search, but still report the cover
+                int essentialCost = 0;
+                for (int i = 0; i < implicants.size(); ++i){
+                    essentialCost += cost[i];
+                }
+                std::vector<Term*> none;
+                std::vector<int> nocost;
+                CoverBest best;
+                greedyCover(NULL, none, none, nocost, nocost, ret, essentialCost, opts, startTime, best);
+                exactCover(NULL, none, none, nocost, nocost, ret, essentialCost, opts, startTime, deadline, best, stats);
+            }
+            return ret;
+        }
+
+        // make smaller table without essential implicants and their covered terms
+        imps_.clear();
+        terms_ = terms;
+        std::vector<int> impcost;
+        std::vector<int> imptie;
+        int essentialCost = 0;
+
+        for (int i = 0; i < implicants.size(); ++i){
+            if (implicants[i]->essential == false){
+                imps_.push_back(implicants[i]);
+                impcost.push_back(cost[i]);
+                imptie.push_back(tie[i]);
+
+            } else {
+                if (pastDeadline(deadline)){
+                    outOfTime = true;
+                    return std::vector<Term*>();
+                }
+                essentialCost += cost[i];
+                for (int k = 0; k < terms.size(); ++k){
+                    if (table[i][k]){
+                        for (int m = 0; m < terms_.size(); ++m){
+                            if (*(terms[k]) == *(terms_[m])){
+                                terms_.erase(terms_.begin() + m);
+                                m--;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        stats.numEssential = implicants.size() - imps_.size();
+
+        table_ = buildPI(terms_, imps_, deadline);
+        if (table_ == NULL){
+            outOfTime = true;
+            return std::vector<Term*>();
+        }
+
+        // with a deadline, the greedy cover shouldn't wait on the dump
+        if (deadline == 0)
+            printPIchart(log, table_, terms_, imps_);
+    //}
+    
+    // greedy cover first, reported before the dominance passes, which can
+    // take a long time on a big chart
+    std::vector<Term*> essentials;
+    for (int i = 0; i < implicants.size(); ++i){
+        if (implicants[i]->essential)
+            essentials.push_back(implicants[i]);
+    }
+    CoverBest best;
+    if (anytime)
+        greedyCover(table_, terms_, imps_, impcost, imptie, essentials, essentialCost,
+                opts, startTime, best);
+
+    if (!reduceChart(table_, terms_, imps_, impcost, imptie, log, deadline)){
+        if (log) fprintf(log, "Deadline reached, chart reduction stopped\n");
+    }
+
+    stats.chartRows = imps_.size();
+    stats.chartCols = terms_.size();
+
+    // then branch and bound on the reduced chart, reporting as it goes
+    if (anytime){
+        exactCover(table_, terms_, imps_, impcost, imptie, essentials, essentialCost,
+                opts, startTime, deadline, best, stats);
+        std::vector<Term*> chosen = best.cover;
+
+        for (int i = 0; i < imps_.size(); ++i){
+            delete[] table_[i];
+        }
+        delete[] table_;
+
+        chosen.insert(chosen.end(), essentials.begin(), essentials.end());
+        sort(chosen.begin(), chosen.end());
+        return chosen;
+    }
+
+    // Find minimum sets of prime implicants that cover all terms
+    bool found = false;
+    std::vector< std::pair< std::vector<Term*>, bool* > > groups; // vector of groups
+    std::vector< std::vector<Term*> > fgroups; // terms that resulted in groups that worked
+    std::vector<bool*> g1;
+    int n = 1;
+
+    // if the essential implicants already cover every term, no group is needed
+    if (terms_.size() == 0){
+        found = true;
+        fgroups.push_back(std::vector<Term*>());
+    }
+
+    // start with the remaining prime implicants
+    // if any of them can cover all the remaining terms, stop here. 
+    for (int i = 0; i < imps_.size(); ++i){
+        bool* row = table_[i];
+        bool good = true;
+        for (int m = 0; m < terms_.size(); ++m){
+            good = good && row[m];
+        }
+        std::pair< std::vector<Term*>, bool* > group;
+        std::vector<Term*> gvec;
+        gvec.push_back(imps_[i]);
+        group = make_pair(gvec, row);
+        groups.push_back(group);
+
+        if (good && terms_.size() > 0){
+            found = true;
+            fgroups.push_back(gvec);
+        }
+    }
+
+    // otherwise, continue adding implicants to groups 
+    // until a single group can cover all remaining terms
+    std::vector< std::pair< std::vector<Term*>, bool* > > newgroups;
+    for (n = 2; n <= imps_.size() && found == false; ++n){
+        newgroups.clear();
+        if (log) fprintf(log, "Trying groups of size %d\n", n);
+        // for each current group
+        for (int i = 0; i < groups.size(); ++i){
+            // try adding each prime implicant
+            for (int k = 0; k < imps_.size(); ++k){
+
+                // skip if the current group includes this implicant
+                bool contains = false;
+                for (int m = 0; m < groups[i].first.size(); ++m){
+                    if (strncmp(groups[i].first[m]->bits, imps_[k]->bits, imps_[k]->len) == 0){
+                        contains = true;
+                        break;
+                    }
+                }
+                if (contains)
+                    continue;
+
+                std::pair< std::vector<Term*>, bool* > group;
+                std::vector<Term*> gvec;
+                gvec = groups[i].first; // copy old term list
+                gvec.push_back(imps_[k]); // add the new one
+                sort(gvec.begin(), gvec.end());
+
+                // also skip if this would create a group that already exists.
+                for (int m = 0; m < newgroups.size(); ++m){
+                    bool cont = false;
+                    for (int z = 0; z < gvec.size(); ++z){
+                        if (strncmp(gvec[z]->bits, newgroups[m].first[z]->bits, gvec[z]->len) != 0){
+                            cont = true;
+                            break;
+                        }
+                    }
+                    if (cont == false){
+                        contains = true;
+                        break;
+                    }
+                }
+                if (contains)
+                    continue;
+
+
+                //printf("group: ");
+                //for (int z = 0; z < groups[i].first.size(); ++z){
+                //    printf("%s ", groups[i].first[z]->bits);
+                //}
+                //printf("\"%s\" old:new  ", imps_[k]->bits);
+
+                bool* row = new bool[terms_.size()];
+                bool good = true;
+                for (int m = 0; m < terms_.size(); ++m){
+                    row[m] = groups[i].second[m] || table_[k][m];
+                    //printf(" %c:%c:%c ", groups[i].second[m]?'1':'0', table_[k][m]?'1':'0', row[m]?'1':'0');
+                    good = good && row[m];
+                }
+                //printf("\n");
+
+                group = make_pair(gvec, row); // construct the pair
+                newgroups.push_back(group); // add it to the list of new groups.
+
+                // if this covers every term, add it to the list
+                // and set the flag to stop after this iteration
+                if (good){
+                    found = true;
+                    fgroups.push_back(gvec);
+                }
+            }
+        }
+
+        // replace old group list with new one.
+        if (n > 2){
+            for (int i = 0; i < groups.size(); ++i){
+                delete[] groups[i].second;
+            }
+        }
+        groups = newgroups;
+    }
+    stats.groupSize = n - 1;
+    // free up memory from group data and the reduced table
+    for (int i = 0; i < newgroups.size(); ++i){
+        delete[] newgroups[i].second;
+    }
+    for (int i = 0; i < imps_.size(); ++i){
+        delete[] table_[i];
+    }
+    delete[] table_;
+
+    // print the groups that cover
+    for (int i = 0; i < fgroups.size(); ++i){
+        if (log) fprintf(log, "Group ");
+        for (int k = 0; k < fgroups[i].size(); ++k){
+            if (log) fprintf(log, "%s ", fgroups[i][k]->bits);
+        }
+        if (log) fprintf(log, " found to cover remaining terms.\n");
+    }
+
+    // find the groups that cover with the fewest literals.
+    // (the most dashes)
+    std::vector<Term*> mostdash;
+    int max = -1;
+    for (int i = 0; i < fgroups.size(); ++i){
+        int dashes = 0;
+        for (int k = 0; k < fgroups[i].size(); ++k){
+            for (int m = 0; m < fgroups[i][k]->len; ++m){
+                if (fgroups[i][k]->bits[m] == '-')
+                    dashes++;
+            }
+        }
+        if (dashes > max){
+            max = dashes;
+            mostdash = fgroups[i];
+        }
+    }
+
+    if (log) fprintf(log, "Group ");
+    for (int k = 0; k < mostdash.size(); ++k){
+        if (log) fprintf(log, "%s ", mostdash[k]->bits);
+    }
+    if (log) fprintf(log, " has the fewest literals.\n");
+
+    // add in the essential prime implicants
+    for (int i = 0; i < implicants.size(); ++i){
+        if (implicants[i]->essential)
+            mostdash.push_back(implicants[i]);
+    }
+
+    sort(mostdash.begin(), mostdash.end());
+    return mostdash;
+
+}
+
+
+// most dashes an input cube may have; it expands into 2^dashes minterms
+#define MAX_CUBE_DASHES 30
+
+// orders terms by their bit strings so the cover prints the same every run
+static bool termLess(const Term* a, const Term* b){
+    return strcmp(a->bits, b->bits) < 0;
+}
+
+void MinResult::clear(){
+    freeTerms(cover);
+}
+
+int countLiterals(const std::vector<Term*>& terms){
+    int literals = 0;
+    for (int i = 0; i < terms.size(); ++i){
+        for (int k = 0; k < terms[i]->len; ++k){
+            if (terms[i]->bits[k] != '-')
+                literals++;
+        }
+    }
+    return literals;
+}
+
+void freeTerms(std::vector<Term*>& terms){
+    for (int i = 0; i < terms.size(); ++i){
+        delete terms[i];
+    }
+    terms.clear();
+}
+
+void printSOP(FILE* out, const std::vector<Term*>& cover){
+    // no terms is constant 0
+    if (cover.size() == 0)
+        fprintf(out, "0");
+    for (int i = 0; i < cover.size(); ++i){
+        int literals = 0;
+        for (int k = 0; k < cover[i]->len; ++k){
+            switch(cover[i]->bits[k]){
+                case '1':
+                    fprintf(out, "%c", 'A'+k);
+                    literals++;
+                    break;
+
+                case '0':
+                    fprintf(out, "%c'", 'A'+k);
+                    literals++;
+                    break;
+            }
+        }
+        // a term of all dashes is constant 1
+        if (literals == 0)
+            fprintf(out, "1");
+        if (i < (int)cover.size()-1)
+            fprintf(out, " + ");
+    }
+}
+
+// Expands cubes into the minterms they cover, dropping duplicates.  A
+// minterm covered by both a one and a don't care is a one.
+static void expandCubes(const std::vector<Term*>& terms, std::vector<Term*>& minterms){
+    for (int i = 0; i < terms.size(); ++i){
+        std::vector<int> dashes;
+        for (int k = 0; k < terms[i]->len; ++k){
+            if (terms[i]->bits[k] == '-')
+                dashes.push_back(k);
+        }
+        for (long long v = 0; v < (1LL << dashes.size()); ++v){
+            Term* m = new Term(*terms[i]);
+            for (int d = 0; d < dashes.size(); ++d){
+                m->bits[dashes[d]] = (v >> d) & 1 ? '1' : '0';
+            }
+            minterms.push_back(m);
+        }
+    }
+
+    sort(minterms.begin(), minterms.end(), termLess);
+    int kept = 0;
+    for (int i = 0; i < minterms.size(); ++i){
+        if (kept > 0 && strcmp(minterms[kept-1]->bits, minterms[i]->bits) == 0){
+            if (minterms[i]->dontcare == false)
+                minterms[kept-1]->dontcare = false;
+            delete minterms[i];
+        } else {
+            minterms[kept++] = minterms[i];
+        }
+    }
+    minterms.resize(kept);
+}
+
+// minimize() once the input is all minterms
+static int minimizeMinterms(const std::vector<Term*>& terms, MinResult& result,
+        const MinOptions& opts, double startTime){
+    FILE* log = opts.log;
+    MinStats& stats = result.stats;
+    stats.numVars = terms.size() > 0 ? terms[0]->len : 0;
+    stats.numTerms = terms.size();
+
+    // the anytime search's deadline covers merging and the chart too.  The
+    // term and chart dumps are skipped then, since they can take longer.
+    bool anytime = opts.anytime || opts.costModel != QM_COST_TERMS;
+    double deadline = anytime && opts.deadline > 0 ? startTime + opts.deadline : 0;
+    FILE* trace = deadline == 0 ? log : NULL;
+
+    // merge terms, through temporary files if memory is bounded
+    std::vector<Term*> merged;
+    bool finished = true;
+    if (opts.memBudget > 0){
+        int err = mergeTermsSpill(terms, opts, deadline, stats, merged, finished);
+        if (err != QM_OK){
+            freeTerms(merged);
+            return err;
+        }
+    } else {
+        merged = mergeTerms(terms, stats, deadline, finished);
+    }
+    stats.numPrimes = merged.size();
+
+    if (trace){
+        fprintf(log, "Original Terms:\n");
+        printTerms(log, terms);
+
+        fprintf(log, "Merged Terms:\n");
+        printTerms(log, merged);
+    }
+
+    // clear essential flags
+    for (int i = 0; i < merged.size(); ++i){
+        merged[i]->essential = false;
+    }
+
+    // get the terms = 1
+    std::vector<Term*> ones;
+    for (int i = 0; i < terms.size(); ++i){
+        if (terms[i]->dontcare == false)
+            ones.push_back(terms[i]);
+    }
+    stats.numOnes = ones.size();
+
+    // each implicant's cost under the cost model, for the cover search
+    std::vector<int> cost(merged.size());
+    std::vector<int> tie(merged.size());
+    for (int i = 0; i < merged.size(); ++i){
+        implicantCost(merged[i], opts, cost[i], tie[i]);
+    }
+
+    // build prime implicant chart, unless merging already ran out of time
+    bool** pichart = finished ? buildPI(ones, merged, deadline) : NULL;
+
+    std::vector<Term*> min;
+    bool outOfTime = (pichart == NULL);
+    if (pichart){
+        printPIchart(trace, pichart, ones, merged);
+        min = findMin(pichart, ones, merged, cost, tie, opts, startTime, stats, outOfTime);
+        printPIchart(trace, pichart, ones, merged);
+    }
+    if (outOfTime){
+        if (pichart){
+            for (int i = 0; i < merged.size(); ++i){
+                delete[] pichart[i];
+            }
+            delete[] pichart;
+            pichart = NULL;
+        }
+        min = fallbackMin(merged, cost, tie, ones, opts, startTime, stats);
+    }
+
+    // findMin hands back the cover sorted by address
+    for (int i = 0; i < merged.size(); ++i){
+        if (binary_search(min.begin(), min.end(), merged[i]))
+            stats.coverCost += cost[i];
+    }
+
+    // hand back copies so the result outlives the prime implicant list
+    for (int i = 0; i < min.size(); ++i){
+        result.cover.push_back(new Term(*min[i]));
+    }
+    sort(result.cover.begin(), result.cover.end(), termLess);
+    stats.coverTerms = result.cover.size();
+    stats.coverLiterals = countLiterals(result.cover);
+
+    // clean up
+    if (pichart){
+        for (int i = 0; i < merged.size(); ++i){
+            delete[] pichart[i];
+        }
+        delete[] pichart;
+    }
+    freeTerms(merged);
+
+    return QM_OK;
+}
+
+int minimize(const std::vector<Term*>& terms, MinResult& result, const MinOptions& opts){
+    double startTime = nowSeconds();
+
+    result.clear();
+    result.stats = MinStats();
+
+    // every term has to be a minterm or cube over the same variables
+    int numVars = terms.size() > 0 ? terms[0]->len : 0;
+    bool cubes = false;
+    for (int i = 0; i < terms.size(); ++i){
+        if (terms[i]->len != numVars)
+            return QM_ERR_INPUT;
+        int dashes = 0;
+        for (int k = 0; k < numVars; ++k){
+            if (terms[i]->bits[k] == '-')
+                dashes++;
+            else if (terms[i]->bits[k] != '0' && terms[i]->bits[k] != '1')
+                return QM_ERR_INPUT;
+        }
+        if (dashes > MAX_CUBE_DASHES)
+            return QM_ERR_INPUT;
+        if (dashes > 0)
+            cubes = true;
+    }
+    if (cubes == false)
+        return minimizeMinterms(terms, result, opts, startTime);
+
+    std::vector<Term*> minterms;
+    expandCubes(terms, minterms);
+    int err = minimizeMinterms(minterms, result, opts, startTime);
+    freeTerms(minterms);
+    return err;
+}
+
+int minimizeTruthTable(int numVars, const char* table, MinResult& result, const MinOptions& opts){
+    result.clear();
+    result.stats = MinStats();
+    if (numVars < 1 || numVars > 30)
+        return QM_ERR_INPUT;
+
+    std::vector<Term*> terms;
+    int numRows = 1 << numVars;
+    for (int t = 0; t < numRows; ++t){
+        if (table[t] == '0')
+            continue;
+        if (table[t] != '1' && table[t] != 'd'){
+            freeTerms(terms);
+            return QM_ERR_INPUT;
+        }
+        Term* term = new Term(numVars);
+        for (int k = 0; k < numVars; ++k){
+            if (t & (1 << (numVars-k-1)))
+                term->bits[k] = '1';
+        }
+        if (table[t] == 'd')
+            term->dontcare = true;
+        terms.push_back(term);
+    }
+
+    int err = minimize(terms, result, opts);
+    result.stats.numVars = numVars;
+    freeTerms(terms);
+    return err;
+}
@@ -0,0 +1,183 @@
+// Quine-McCluskey minimization library
+//
+// Patrick Mealey
+// Joseph Gebhard
+//
+// The minimizer keeps no global state, so separate threads can each run
+// minimize() on their own inputs at the same time.  Nothing is printed
+// unless a log stream is passed in through MinOptions.
+
+#ifndef QM_H
+#define QM_H
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+struct Term{
+    char* bits;
+    bool dontcare;
+    bool essential;
+    int len;
+    int copied;
+
+    //intiallize an empty term struct
+    Term(int sz = 4) : dontcare(false), essential(false), len(sz),copied(0) {
+        bits = new char[sz+1];
+        memset(bits, '0', sz);
+        bits[sz] = 0;
+    }
+    ~Term() {
+        delete[] bits;
+        //printf("deleting term which has been copied %d times.\n", copied);
+    }
+
+    //create a clone of another term, incrementing the copied counter
+    Term( const Term& other ) :
+        dontcare(other.dontcare), essential(other.essential), len(other.len),copied(other.copied+1) {
+            bits = new char[len+1];
+            strncpy(bits, other.bits, len+1);
+            bits[len] = 0;
+        }
+
+    //overload the 'equals' comparaison operateer
+    bool operator== (const Term& other){
+        if (strncmp(bits, other.bits, len) == 0)
+            if (dontcare == other.dontcare && essential == other.essential && len == other.len)
+                return true;
+        return false;
+    }
+};
+
+// error codes returned by the minimize functions
+enum {
+    QM_OK = 0,
+    QM_ERR_INPUT = 3,   // bad character, length mismatch, too many variables, or a
+                        // cube with more than 30 dashes
+    QM_ERR_IO = 4       // a temporary spill file could not be created or written
+};
+
+// what the cover search minimizes.  Ties are broken by literal count, or
+// by term count under QM_COST_LITERALS.
+enum {
+    QM_COST_TERMS,      // number of product terms
+    QM_COST_LITERALS,   // total literals over all terms
+    QM_COST_WEIGHTED    // termWeight per term plus literalWeight per literal
+};
+
+// progress events reported by the anytime cover search
+enum {
+    QM_PROGRESS_GREEDY,     // first cover, from the greedy pass
+    QM_PROGRESS_IMPROVED,   // the exact search found a better cover
+    QM_PROGRESS_DONE        // search finished or hit the deadline
+};
+
+struct MinProgress {
+    int event;
+    const std::vector<Term*>* cover;    // full cover; only valid during the callback
+    int coverTerms;
+    int coverLiterals;
+    int coverCost;      // under the cost model
+    int lowerBound;     // no cover costs less than this
+    bool optimal;       // the cover is proven minimum
+    double elapsed;     // seconds since minimize() started
+};
+
+typedef void (*MinProgressFn)(const MinProgress& progress, void* ctx);
+
+// knobs for a single minimize() call
+struct MinOptions {
+    FILE* log;          // trace output (merge rounds, PI charts, dominance); NULL for none
+    size_t memBudget;   // bytes for merge round buffers; 0 keeps every round in memory
+    const char* tmpDir; // where spill files go when memBudget is set; NULL for the default
+    bool anytime;       // greedy cover first, then branch and bound instead of group search
+    int costModel;      // QM_COST_*; anything but QM_COST_TERMS also uses branch and bound
+    int termWeight;     // QM_COST_WEIGHTED: e.g. 2 for an AND gate plus its OR input
+    int literalWeight;  // QM_COST_WEIGHTED: e.g. 1 per AND gate input
+    double deadline;    // anytime search: seconds from the start of minimize() after which
+                        // merging, the chart and the search stop; 0 for no limit.  If
+                        // it passes before the chart is reduced, the cover is every
+                        // cube merged so far or the ones, whichever costs less.  The
+                        // term and chart dumps are left out of the log when set.
+    MinProgressFn progress;     // called with each cover the anytime search finds
+    void* progressCtx;
+
+    MinOptions() : log(NULL), memBudget(0), tmpDir(NULL), anytime(false),
+        costModel(QM_COST_TERMS), termWeight(2), literalWeight(1),
+        deadline(0), progress(NULL), progressCtx(NULL) {}
+};
+
+// counters filled in by minimize()
+struct MinStats {
+    int numVars;
+    int numTerms;       // input minterms, ones and don't cares, after expanding cubes
+    int numOnes;        // terms the cover has to include
+    int mergeRounds;
+    int numPrimes;
+    int numEssential;
+    int chartRows;      // implicants left after essential removal and dominance
+    int chartCols;      // terms left after essential removal and dominance
+    int groupSize;      // largest group size tried by the cover search
+    int coverTerms;
+    int coverLiterals;
+    int coverCost;      // under the cost model
+    int spillRuns;      // sorted runs written to disk in memory bounded mode
+    long long spillBytes;
+    long long searchNodes;  // branch and bound nodes visited
+    int lowerBound;     // branch and bound: no cover costs less than this
+    bool optimal;       // branch and bound: the search finished before the deadline
+
+    MinStats() : numVars(0), numTerms(0), numOnes(0), mergeRounds(0),
+        numPrimes(0), numEssential(0), chartRows(0), chartCols(0),
+        groupSize(0), coverTerms(0), coverLiterals(0), coverCost(0), spillRuns(0),
+        spillBytes(0), searchNodes(0), lowerBound(0), optimal(false) {}
+};
+
+// result of a minimize() call.  The cover terms are owned by the result
+// and freed with it.
+struct MinResult {
+    std::vector<Term*> cover;
+    MinStats stats;
+
+    MinResult() {}
+    ~MinResult() { clear(); }
+    void clear();
+
+private:
+    MinResult(const MinResult&);
+    MinResult& operator= (const MinResult&);
+};
+
+// Minimize the function given by a list of terms (ones and don't cares,
+// all of the same length).  Terms may be cubes with '-' for either value;
+// they are expanded into the minterms they cover, and a minterm listed as
+// both a one and a don't care is a one.  The input terms are not modified.
+int minimize(const std::vector<Term*>& terms, MinResult& result,
+        const MinOptions& opts = MinOptions());
+
+// Minimize a function given as a truth table of 2^numVars entries, indexed
+// with variable A as the most significant bit.  Each entry is '1', '0' or
+// 'd' (don't care).
+int minimizeTruthTable(int numVars, const char* table, MinResult& result,
+        const MinOptions& opts = MinOptions());
+
+// count of non-dash positions over all terms
+int countLiterals(const std::vector<Term*>& terms);
+
+// deletes every term in the vector and empties it
+void freeTerms(std::vector<Term*>& terms);
+
+//displays everything in the term vector one term per line
+void printTerms(FILE* out, const std::vector<Term*>& terms);
+
+// prints the cover as a sum of products, e.g. "A'D + BC'", or "0" / "1"
+// for a constant function
+void printSOP(FILE* out, const std::vector<Term*>& cover);
+
+// Factors a cover into a multi-level expression, e.g. "A'(D + BC')", and
+// counts its literals.  Covers over more than 32 variables are rejected
+// with QM_ERR_INPUT.
+int factorCover(const std::vector<Term*>& cover, std::string& expr, int& literals);
+
+#endif
@@ -0,0 +1,449 @@
+// Out of core merge rounds for the Quine-McCluskey minimizer
+//
+// A round is a temporary file of distinct cubes in sorted order, one record
+// per cube: the bits followed by a don't care byte.  Two cubes merge when
+// they have dashes in the same places and differ in one other bit, so
+// instead of comparing every pair we write, for each cube and each
+// non-dash bit p, a key record holding the cube with bit p turned into a
+// dash.  Once the keys are sorted, the two halves of a merge end up next
+// to each other.  The sorted order also gives the next round already
+// deduplicated, and a second sorted stream of the cubes that took part in
+// a merge lets the primes be picked out with a single merge join.
+
+#include "spill.h"
+#include "cover.h"
+
+#include <algorithm>
+#include <string>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace std;
+
+// most runs merged at once, to stay well under the open file limit
+#define MAX_FANIN 64
+
+FILE* openTemp(const char* tmpDir){
+    if (tmpDir == NULL)
+        return tmpfile();
+
+    std::string path = std::string(tmpDir) + "/qmspillXXXXXX";
+    std::vector<char> name(path.begin(), path.end());
+    name.push_back(0);
+    int fd = mkstemp(&name[0]);
+    if (fd < 0)
+        return NULL;
+    unlink(&name[0]);
+    FILE* f = fdopen(fd, "w+b");
+    if (f == NULL)
+        close(fd);
+    return f;
+}
+
+// orders buffer slots by the records they point at
+struct BufLess {
+    const char* buf;
+    int recSize;
+    BufLess(const char* b, int sz) : buf(b), recSize(sz) {}
+    bool operator() (int a, int b) const {
+        return memcmp(buf + (size_t)a*recSize, buf + (size_t)b*recSize, recSize) < 0;
+    }
+};
+
+// heap order for the k-way merge; the smallest head ends up on top
+struct RunSorter::HeadLess {
+    const RunSorter* s;
+    HeadLess(const RunSorter* sorter) : s(sorter) {}
+    bool operator() (int a, int b) const {
+        return memcmp(&s->heads[(size_t)a*s->recSize], &s->heads[(size_t)b*s->recSize], s->recSize) > 0;
+    }
+};
+
+RunSorter::RunSorter(int recSize, size_t budget, const char* tmpDir, bool dedup) :
+    recSize(recSize), tmpDir(tmpDir), dedup(dedup), count(0), haveLast(false),
+    pos(0), numRuns(0), spilled(0) {
+    // each buffered record also costs a slot in the sort order
+    capacity = budget / (recSize + sizeof(int));
+    if (capacity < 16)
+        capacity = 16;
+    last.resize(recSize);
+}
+
+RunSorter::~RunSorter(){
+    for (int i = 0; i < files.size(); ++i){
+        if (files[i])
+            fclose(files[i]);
+    }
+}
+
+void RunSorter::sortBuffer(){
+    order.resize(count);
+    for (int i = 0; i < count; ++i){
+        order[i] = i;
+    }
+    sort(order.begin(), order.end(), BufLess(&buf[0], recSize));
+}
+
+bool RunSorter::add(const char* rec){
+    // the budget is a ceiling; the buffer only grows as records arrive
+    if ((count + 1) * recSize > buf.size()){
+        size_t grow = count < 16 ? 16 : count * 2;
+        if (grow > capacity)
+            grow = capacity;
+        buf.resize(grow * recSize);
+    }
+    memcpy(&buf[count * recSize], rec, recSize);
+    count++;
+    if (count == capacity)
+        return spillBuffer();
+    return true;
+}
+
+bool RunSorter::spillBuffer(){
+    FILE* f = openTemp(tmpDir);
+    if (f == NULL)
+        return false;
+
+    sortBuffer();
+    const char* prev = NULL;
+    for (int i = 0; i < count; ++i){
+        const char* rec = &buf[(size_t)order[i] * recSize];
+        if (dedup && prev && memcmp(prev, rec, recSize) == 0)
+            continue;
+        if (fwrite(rec, recSize, 1, f) != 1){
+            fclose(f);
+            return false;
+        }
+        spilled += recSize;
+        prev = rec;
+    }
+    if (fflush(f) != 0){
+        fclose(f);
+        return false;
+    }
+    rewind(f);
+
+    files.push_back(f);
+    numRuns++;
+    count = 0;
+    return true;
+}
+
+bool RunSorter::readHead(int run){
+    return fread(&heads[(size_t)run * recSize], recSize, 1, files[run]) == 1;
+}
+
+void RunSorter::startMerge(const std::vector<FILE*>& in){
+    files = in;
+    heads.resize(files.size() * recSize);
+    heap.clear();
+    for (int i = 0; i < files.size(); ++i){
+        if (readHead(i))
+            heap.push_back(i);
+    }
+    make_heap(heap.begin(), heap.end(), HeadLess(this));
+}
+
+bool RunSorter::popMerged(char* rec){
+    if (heap.empty())
+        return false;
+
+    pop_heap(heap.begin(), heap.end(), HeadLess(this));
+    int run = heap.back();
+    memcpy(rec, &heads[(size_t)run * recSize], recSize);
+    if (readHead(run))
+        push_heap(heap.begin(), heap.end(), HeadLess(this));
+    else
+        heap.pop_back();
+    return true;
+}
+
+bool RunSorter::finish(){
+    // everything fit in memory, so serve it straight from the buffer
+    if (files.empty()){
+        sortBuffer();
+        pos = 0;
+        return true;
+    }
+    if (count > 0 && !spillBuffer())
+        return false;
+    // hand the buffer back for the rest of the merge
+    std::vector<char>().swap(buf);
+    std::vector<int>().swap(order);
+
+    // cut the number of runs down until one merge can read them all
+    std::vector<char> rec(recSize);
+    while (files.size() > MAX_FANIN){
+        std::vector<FILE*> rest(files.begin() + MAX_FANIN, files.end());
+        std::vector<FILE*> group(files.begin(), files.begin() + MAX_FANIN);
+
+        FILE* out = openTemp(tmpDir);
+        if (out == NULL)
+            return false;
+        startMerge(group);
+        bool ok = true;
+        bool first = true;
+        while (popMerged(&rec[0])){
+            if (dedup && !first && memcmp(&last[0], &rec[0], recSize) == 0)
+                continue;
+            if (fwrite(&rec[0], recSize, 1, out) != 1){
+                ok = false;
+                break;
+            }
+            spilled += recSize;
+            memcpy(&last[0], &rec[0], recSize);
+            first = false;
+        }
+        for (int i = 0; i < group.size(); ++i){
+            fclose(group[i]);
+        }
+        files = rest;
+        files.push_back(out);
+        if (!ok || fflush(out) != 0)
+            return false;
+        rewind(out);
+        numRuns++;
+    }
+
+    startMerge(files);
+    haveLast = false;
+    return true;
+}
+
+bool RunSorter::next(char* rec){
+    while (true){
+        if (files.empty()){
+            if (pos >= count)
+                return false;
+            memcpy(rec, &buf[(size_t)order[pos++] * recSize], recSize);
+        } else if (!popMerged(rec)){
+            return false;
+        }
+
+        if (dedup && haveLast && memcmp(&last[0], rec, recSize) == 0)
+            continue;
+        memcpy(&last[0], rec, recSize);
+        haveLast = true;
+        return true;
+    }
+}
+
+// key records: the merged cube, the bit that was turned into a dash (two
+// bytes, high byte first so keys still sort by position), and a flag byte
+// holding the value the bit had and the cube's don't care flag
+#define KEY_HALF 2
+#define KEY_DC 1
+#define KEY_MAX_VARS 65536
+
+int mergeTermsSpill(const std::vector<Term*>& terms, const MinOptions& opts,
+        double deadline, MinStats& stats, std::vector<Term*>& primes, bool& finished){
+    if (terms.size() == 0)
+        return QM_OK;
+
+    int len = terms[0]->len;
+    if (len > KEY_MAX_VARS)
+        return QM_ERR_INPUT;
+    int cubeSize = len + 1;
+    int keySize = len + 3;
+    size_t budget = opts.memBudget;
+
+    // round 0 is the sorted input terms with duplicates dropped.  A term
+    // listed as both a one and a don't care sorts with its one first.
+    FILE* round = openTemp(opts.tmpDir);
+    if (round == NULL)
+        return QM_ERR_IO;
+    {
+        RunSorter input(cubeSize, budget, opts.tmpDir, true);
+        std::vector<char> cube(cubeSize);
+        for (int i = 0; i < terms.size(); ++i){
+            memcpy(&cube[0], terms[i]->bits, len);
+            cube[len] = terms[i]->dontcare ? 1 : 0;
+            if (!input.add(&cube[0])){
+                fclose(round);
+                return QM_ERR_IO;
+            }
+        }
+        if (!input.finish()){
+            fclose(round);
+            return QM_ERR_IO;
+        }
+        std::vector<char> prev;
+        while (input.next(&cube[0])){
+            if (prev.size() && memcmp(&prev[0], &cube[0], len) == 0)
+                continue;
+            prev = cube;
+            if (fwrite(&cube[0], cubeSize, 1, round) != 1){
+                fclose(round);
+                return QM_ERR_IO;
+            }
+            stats.spillBytes += cubeSize;
+        }
+        stats.spillRuns += input.runs();
+        stats.spillBytes += input.bytesSpilled();
+    }
+
+    std::vector<char> cube(cubeSize);
+    std::vector<char> key(keySize);
+    std::vector<char> group;
+    std::vector<char> merged(cubeSize);
+    std::vector<char> covered(len);
+    int err = QM_OK;
+    bool timedOut = false;
+
+    // loop until nothing can be merged.
+    bool done = false;
+    while (done == false && err == QM_OK){
+        if (pastDeadline(deadline)){
+            timedOut = true;
+            break;
+        }
+        // both sorters are alive during the key scan, so they split the budget
+        RunSorter keys(keySize, budget / 2, opts.tmpDir, false);
+        RunSorter used(len, budget / 2, opts.tmpDir, true);
+        FILE* nextRound = openTemp(opts.tmpDir);
+        if (fflush(round) != 0 || nextRound == NULL){
+            err = QM_ERR_IO;
+            if (nextRound)
+                fclose(nextRound);
+            break;
+        }
+        rewind(round);
+
+        // write a key for every bit of every cube that could become a dash
+        while (err == QM_OK && fread(&cube[0], cubeSize, 1, round) == 1){
+            if (pastDeadline(deadline)){
+                timedOut = true;
+                break;
+            }
+            for (int p = 0; p < len; ++p){
+                if (cube[p] == '-')
+                    continue;
+                memcpy(&key[0], &cube[0], len);
+                key[p] = '-';
+                key[len] = (char)(p >> 8);
+                key[len+1] = (char)(p & 0xff);
+                key[len+2] = (cube[p] == '1' ? KEY_HALF : 0) | cube[len];
+                if (!keys.add(&key[0]))
+                    err = QM_ERR_IO;
+            }
+        }
+        if (timedOut){
+            fclose(nextRound);
+            break;
+        }
+        if (err != QM_OK || !keys.finish()){
+            err = QM_ERR_IO;
+            fclose(nextRound);
+            break;
+        }
+
+        // walk the keys one merged cube at a time.  Within a cube the
+        // records are ordered by dash position and then half, so a merge
+        // shows up as a 0 half directly followed by a 1 half.
+        int nextCount = 0;
+        bool more = keys.next(&key[0]);
+        while (more && err == QM_OK){
+            if (pastDeadline(deadline)){
+                timedOut = true;
+                break;
+            }
+            group.assign(key.begin(), key.end());
+            int groupRecs = 1;
+            while ((more = keys.next(&key[0])) && memcmp(&key[0], &group[0], len) == 0){
+                group.insert(group.end(), key.begin(), key.end());
+                groupRecs++;
+            }
+
+            bool found = false;
+            bool dontcare = true;
+            for (int i = 0; i + 1 < groupRecs; ++i){
+                const char* lo = &group[(size_t)i * keySize];
+                const char* hi = lo + keySize;
+                if (memcmp(lo + len, hi + len, 2) != 0 || (lo[len+2] & KEY_HALF) || !(hi[len+2] & KEY_HALF))
+                    continue;
+
+                found = true;
+                if (!(lo[len+2] & KEY_DC) || !(hi[len+2] & KEY_DC))
+                    dontcare = false;
+
+                // both halves merged, so neither is prime
+                int p = ((unsigned char)lo[len] << 8) | (unsigned char)lo[len+1];
+                memcpy(&covered[0], lo, len);
+                covered[p] = '0';
+                if (!used.add(&covered[0]))
+                    err = QM_ERR_IO;
+                covered[p] = '1';
+                if (!used.add(&covered[0]))
+                    err = QM_ERR_IO;
+            }
+            if (found){
+                memcpy(&merged[0], &group[0], len);
+                merged[len] = dontcare ? 1 : 0;
+                if (fwrite(&merged[0], cubeSize, 1, nextRound) != 1)
+                    err = QM_ERR_IO;
+                stats.spillBytes += cubeSize;
+                nextCount++;
+            }
+        }
+        if (timedOut){
+            fclose(nextRound);
+            break;
+        }
+        if (err != QM_OK || !used.finish()){
+            err = QM_ERR_IO;
+            fclose(nextRound);
+            break;
+        }
+
+        // anything that couldn't be merged (and isn't a don't care) is prime
+        rewind(round);
+        bool haveUsed = used.next(&covered[0]);
+        while (fread(&cube[0], cubeSize, 1, round) == 1){
+            while (haveUsed && memcmp(&covered[0], &cube[0], len) < 0){
+                haveUsed = used.next(&covered[0]);
+            }
+            if (haveUsed && memcmp(&covered[0], &cube[0], len) == 0)
+                continue;
+            if (cube[len])
+                continue;
+
+            Term* prime = new Term(len);
+            memcpy(prime->bits, &cube[0], len);
+            prime->essential = true;
+            primes.push_back(prime);
+        }
+
+        stats.mergeRounds++;
+        stats.spillRuns += keys.runs() + used.runs();
+        stats.spillBytes += keys.bytesSpilled() + used.bytesSpilled();
+        if (opts.log){
+            fprintf(opts.log, "Merge round %d: %d cubes merged, %d primes so far, %d runs spilled\n",
+                    stats.mergeRounds, nextCount, (int)primes.size(), keys.runs() + used.runs());
+        }
+
+        fclose(round);
+        round = nextRound;
+        if (nextCount == 0)
+            done = true;
+    }
+
+    // out of time: the round in progress and the primes found before it
+    // still cover every one
+    if (timedOut && err == QM_OK){
+        finished = false;
+        if (fflush(round) != 0)
+            err = QM_ERR_IO;
+        rewind(round);
+        while (err == QM_OK && fread(&cube[0], cubeSize, 1, round) == 1){
+            if (cube[len])
+                continue;
+            Term* term = new Term(len);
+            memcpy(term->bits, &cube[0], len);
+            primes.push_back(term);
+        }
+    }
+
+    fclose(round);
+    return err;
+}
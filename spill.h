@@ -0,0 +1,73 @@
+// Out of core merge rounds for the Quine-McCluskey minimizer
+//
+// Used by minimize() when MinOptions.memBudget is set.  Each merge round is
+// kept in a temporary file instead of memory, and the sorting it needs is
+// done with sorted runs that are spilled to disk and merged back together.
+
+#ifndef SPILL_H
+#define SPILL_H
+
+#include <stdio.h>
+#include <vector>
+
+#include "qm.h"
+
+// Sorts fixed size records into memcmp order using at most about 'budget'
+// bytes of memory.  When the buffer fills, it is sorted and written out as
+// a run; finish() then merges the runs back together.  With dedup set,
+// identical records are only returned once.
+class RunSorter {
+public:
+    RunSorter(int recSize, size_t budget, const char* tmpDir, bool dedup);
+    ~RunSorter();
+
+    bool add(const char* rec);  // false if a run could not be written
+    bool finish();              // no more adds; false on I/O error
+    bool next(char* rec);       // copies out the next record, false at the end
+
+    int runs() const { return numRuns; }
+    long long bytesSpilled() const { return spilled; }
+
+private:
+    struct HeadLess;
+
+    bool spillBuffer();
+    void sortBuffer();
+    void startMerge(const std::vector<FILE*>& in);
+    bool popMerged(char* rec);
+    bool readHead(int run);
+
+    int recSize;
+    size_t capacity;            // records that fit in the buffer
+    const char* tmpDir;
+    bool dedup;
+
+    std::vector<char> buf;
+    std::vector<int> order;     // buffer records in sorted order
+    size_t count;
+
+    std::vector<FILE*> files;   // runs being merged by next()
+    std::vector<char> heads;    // current record of each run
+    std::vector<int> heap;      // runs ordered by their current record
+    std::vector<char> last;
+    bool haveLast;
+    size_t pos;                 // next buffer record when nothing spilled
+
+    int numRuns;
+    long long spilled;
+};
+
+// opens an anonymous read/write temporary file in tmpDir (or the system
+// default when tmpDir is NULL).  It is removed when closed.
+FILE* openTemp(const char* tmpDir);
+
+// Runs the merge rounds with bounded memory, appending the prime
+// implicants to 'primes'.  Returns QM_OK, QM_ERR_IO, or QM_ERR_INPUT for
+// more than 65536 variables.  If the deadline (an absolute nowSeconds()
+// time, 0 for none) passes first, finished is set false and the cubes of
+// the round in progress are appended too, so 'primes' still covers every
+// one.
+int mergeTermsSpill(const std::vector<Term*>& terms, const MinOptions& opts,
+        double deadline, MinStats& stats, std::vector<Term*>& primes, bool& finished);
+
+#endif